@@ -0,0 +1,107 @@
+#pragma once
+#include "zpp_bits.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace zpp_bits_benchmark
+{
+class state
+{
+public:
+    explicit state(std::chrono::nanoseconds budget) : m_budget(budget)
+    {
+    }
+
+    // Runs `function` repeatedly until the time budget is exhausted.
+    void run(auto && function)
+    {
+        using clock = std::chrono::steady_clock;
+
+        function();
+
+        std::size_t batch = 1;
+        auto start = clock::now();
+        auto elapsed = clock::duration{};
+        while (elapsed < m_budget) {
+            for (std::size_t i = 0; i < batch; ++i) {
+                function();
+            }
+            m_iterations += batch;
+            elapsed = clock::now() - start;
+            batch *= 2;
+        }
+        m_elapsed = elapsed;
+    }
+
+    void bytes_per_iteration(std::size_t bytes)
+    {
+        m_bytes = bytes;
+    }
+
+    void items_per_iteration(std::size_t items)
+    {
+        m_items = items;
+    }
+
+    void report(const char * name) const
+    {
+        auto nanoseconds =
+            std::chrono::duration<double, std::nano>(m_elapsed).count() /
+            double(m_iterations);
+        std::printf("%-56s %14.1f ns", name, nanoseconds);
+        if (m_bytes) {
+            std::printf(" %10.1f MB/s", double(m_bytes) * 1e3 / nanoseconds);
+        }
+        if (m_items) {
+            std::printf(" %10.2f ns/item", nanoseconds / double(m_items));
+        }
+        std::printf("\n");
+    }
+
+private:
+    std::chrono::nanoseconds m_budget;
+    std::chrono::steady_clock::duration m_elapsed{};
+    std::size_t m_iterations{};
+    std::size_t m_bytes{};
+    std::size_t m_items{};
+};
+
+struct registration
+{
+    std::string name;
+    std::function<void(state &)> function;
+};
+
+inline std::vector<registration> & registry()
+{
+    static std::vector<registration> benchmarks;
+    return benchmarks;
+}
+
+struct registrar
+{
+    registrar(const char * suite, const char * name, void (*function)(state &))
+    {
+        registry().push_back({std::string(suite) + "." + name, function});
+    }
+};
+
+template <typename Type>
+inline void do_not_optimize(Type && value)
+{
+#if defined __clang__ || defined __GNUC__
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(static_cast<volatile const void *>(&value));
+#endif
+}
+} // namespace zpp_bits_benchmark
+
+#define ZPP_BITS_BENCHMARK(suite, name)                                    \
+    static void suite##_##name(::zpp_bits_benchmark::state &);             \
+    static ::zpp_bits_benchmark::registrar suite##_##name##_registrar{     \
+        #suite, #name, suite##_##name};                                    \
+    static void suite##_##name(::zpp_bits_benchmark::state & state)
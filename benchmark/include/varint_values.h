@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Varint values shared by the varint benchmarks.
+namespace benchmark_varint
+{
+constexpr std::size_t value_count = 0x100000;
+
+// A value whose varint encoding takes size bytes.
+inline std::uint64_t value_of_size(std::mt19937_64 & random, std::size_t size)
+{
+    if (size >= 10) {
+        return random() | (std::uint64_t{1} << 63);
+    }
+    auto bits = size * 7;
+    auto top = std::uint64_t{1} << (bits - 1);
+    return top | (random() & (top - 1));
+}
+
+template <typename SizeDistribution>
+std::vector<std::uint64_t> values(SizeDistribution size_distribution)
+{
+    std::mt19937_64 random(0x5eed);
+    std::vector<std::uint64_t> values;
+    for (std::size_t i = 0; i < value_count; ++i) {
+        values.push_back(value_of_size(random, size_distribution(random)));
+    }
+    return values;
+}
+
+// Mostly one and two bytes, as with tags, sizes and small counters.
+constexpr auto small_size = [](auto & random) {
+    auto roll = random() % 100;
+    return roll < 70 ? 1 : roll < 95 ? 2 : 3 + roll % 3;
+};
+
+constexpr auto uniform_size = [](auto & random) {
+    return 1 + random() % 10;
+};
+
+constexpr auto ten_bytes = [](auto &) { return 10; };
+} // namespace benchmark_varint
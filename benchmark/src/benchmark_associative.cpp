@@ -0,0 +1,57 @@
+#include "benchmark.h"
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace benchmark_associative
+{
+constexpr std::uint64_t entry_count = 1'000'000;
+
+template <typename Container>
+const std::vector<std::byte> & encoded()
+{
+    static const auto data = [] {
+        Container container;
+        for (std::uint64_t i = 0; i < entry_count; ++i) {
+            if constexpr (requires { typename Container::mapped_type; }) {
+                container.emplace(i * 7, i);
+            } else {
+                container.emplace(i * 7);
+            }
+        }
+        auto [data, out] = zpp::bits::data_out();
+        out(container).or_throw();
+        return data;
+    }();
+    return data;
+}
+
+template <typename Container>
+void decode(auto & state)
+{
+    auto & data = encoded<Container>();
+    state.run([&] {
+        Container container;
+        zpp::bits::in{data}(container).or_throw();
+        zpp_bits_benchmark::do_not_optimize(container);
+    });
+    state.bytes_per_iteration(data.size());
+    state.items_per_iteration(entry_count);
+}
+
+ZPP_BITS_BENCHMARK(associative, map)
+{
+    decode<std::map<std::uint64_t, std::uint64_t>>(state);
+}
+
+ZPP_BITS_BENCHMARK(associative, unordered_map)
+{
+    decode<std::unordered_map<std::uint64_t, std::uint64_t>>(state);
+}
+
+ZPP_BITS_BENCHMARK(associative, set)
+{
+    decode<std::set<std::uint64_t>>(state);
+}
+
+} // namespace benchmark_associative
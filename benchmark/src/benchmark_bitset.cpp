@@ -0,0 +1,76 @@
+#include "benchmark.h"
+#include <bitset>
+
+namespace benchmark_bitset
+{
+constexpr std::size_t bit_count = 65536;
+
+const std::bitset<bit_count> & bits()
+{
+    static const auto bits = [] {
+        std::bitset<bit_count> bits;
+        for (std::size_t i = 0; i < bits.size(); i += 3) {
+            bits.set(i);
+        }
+        return bits;
+    }();
+    return bits;
+}
+
+ZPP_BITS_BENCHMARK(bitset, encode)
+{
+    std::vector<std::byte> data(bit_count / 8);
+    state.run([&] {
+        zpp::bits::out out(data);
+        out(bits()).or_throw();
+        zpp_bits_benchmark::do_not_optimize(data);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(bitset, decode)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(bits()).or_throw();
+    std::bitset<bit_count> decoded;
+    state.run([&] {
+        zpp::bits::in in(data);
+        in(decoded).or_throw();
+        zpp_bits_benchmark::do_not_optimize(decoded);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(bitset, encode_vector_bool)
+{
+    std::vector<bool> values(bit_count);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = bits()[i];
+    }
+    std::vector<std::byte> data(sizeof(std::uint32_t) + bit_count / 8);
+    state.run([&] {
+        zpp::bits::out out(data);
+        out(values).or_throw();
+        zpp_bits_benchmark::do_not_optimize(data);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(bitset, decode_vector_bool)
+{
+    std::vector<bool> values(bit_count);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = bits()[i];
+    }
+    auto [data, out] = zpp::bits::data_out();
+    out(values).or_throw();
+    std::vector<bool> decoded;
+    state.run([&] {
+        zpp::bits::in in(data);
+        in(decoded).or_throw();
+        zpp_bits_benchmark::do_not_optimize(decoded);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+} // namespace benchmark_bitset
@@ -0,0 +1,50 @@
+#include "benchmark.h"
+
+namespace benchmark_blob
+{
+constexpr std::size_t blob_size = 0x400000;
+
+template <typename Container>
+const std::vector<std::byte> & encoded()
+{
+    static const auto data = [] {
+        Container container(blob_size / sizeof(typename Container::value_type),
+                            typename Container::value_type{});
+        for (std::size_t i = 0; i < container.size(); ++i) {
+            container[i] = typename Container::value_type(i * 31);
+        }
+        auto [data, out] = zpp::bits::data_out();
+        out(container).or_throw();
+        return data;
+    }();
+    return data;
+}
+
+template <typename Container>
+void decode(auto & state)
+{
+    auto & data = encoded<Container>();
+    state.run([&] {
+        Container container;
+        zpp::bits::in{data}(container).or_throw();
+        zpp_bits_benchmark::do_not_optimize(container);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(blob, string)
+{
+    decode<std::string>(state);
+}
+
+ZPP_BITS_BENCHMARK(blob, byte_vector)
+{
+    decode<std::vector<std::byte>>(state);
+}
+
+ZPP_BITS_BENCHMARK(blob, uint32_vector)
+{
+    decode<std::vector<std::uint32_t>>(state);
+}
+
+} // namespace benchmark_blob
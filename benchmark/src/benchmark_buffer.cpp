@@ -0,0 +1,76 @@
+#include "benchmark.h"
+
+namespace benchmark_buffer
+{
+struct message
+{
+    std::uint64_t id;
+    std::string name;
+    std::vector<std::uint64_t> values;
+    std::vector<std::string> tags;
+};
+
+const message & large_message()
+{
+    static const message value = [] {
+        message value{1, std::string(0x100, 'x'), {}, {}};
+        value.values.resize(0x80000);
+        for (std::size_t i = 0; i < value.values.size(); ++i) {
+            value.values[i] = i * 0x9e3779b97f4a7c15ull;
+        }
+        for (std::size_t i = 0; i < 0x4000; ++i) {
+            value.tags.push_back(std::to_string(i));
+        }
+        return value;
+    }();
+    return value;
+}
+
+template <typename Data>
+void serialize_large(zpp_bits_benchmark::state & state)
+{
+    auto & value = large_message();
+    std::size_t size{};
+    state.run([&] {
+        auto [data, out] = zpp::bits::data_out<Data>();
+        out(value).or_throw();
+        size = data.size();
+        zpp_bits_benchmark::do_not_optimize(data.data());
+    });
+    state.bytes_per_iteration(size);
+}
+
+template <typename Data>
+void serialize_many_small(zpp_bits_benchmark::state & state)
+{
+    state.run([&] {
+        auto [data, out] = zpp::bits::data_out<Data>();
+        for (std::uint32_t i = 0; i < 0x4000; ++i) {
+            out(i, std::uint16_t(i)).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(data.data());
+    });
+    state.bytes_per_iteration(0x4000 * 6);
+}
+
+ZPP_BITS_BENCHMARK(buffer, large_vector)
+{
+    serialize_large<std::vector<std::byte>>(state);
+}
+
+ZPP_BITS_BENCHMARK(buffer, large_buffer)
+{
+    serialize_large<zpp::bits::buffer<>>(state);
+}
+
+ZPP_BITS_BENCHMARK(buffer, many_small_vector)
+{
+    serialize_many_small<std::vector<std::byte>>(state);
+}
+
+ZPP_BITS_BENCHMARK(buffer, many_small_buffer)
+{
+    serialize_many_small<zpp::bits::buffer<>>(state);
+}
+
+} // namespace benchmark_buffer
@@ -0,0 +1,68 @@
+#include "benchmark.h"
+
+namespace benchmark_endian
+{
+constexpr std::size_t element_count = 0x40000;
+
+template <typename Type>
+const std::vector<Type> & elements()
+{
+    static const auto elements = [] {
+        std::vector<Type> elements(element_count);
+        for (std::size_t i = 0; i < elements.size(); ++i) {
+            elements[i] = Type(i * 2654435761u);
+        }
+        return elements;
+    }();
+    return elements;
+}
+
+template <typename Type>
+void encode(auto & state)
+{
+    auto & values = elements<Type>();
+    std::vector<std::byte> data(sizeof(std::uint32_t) +
+                                values.size() * sizeof(Type));
+    state.run([&] {
+        zpp::bits::out out(data, zpp::bits::endian::big{});
+        out(values).or_throw();
+        zpp_bits_benchmark::do_not_optimize(data);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+template <typename Type>
+void decode(auto & state)
+{
+    auto [data, out] = zpp::bits::data_out(zpp::bits::endian::big{});
+    out(elements<Type>()).or_throw();
+    std::vector<Type> values;
+    state.run([&] {
+        zpp::bits::in in(data, zpp::bits::endian::big{});
+        in(values).or_throw();
+        zpp_bits_benchmark::do_not_optimize(values);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(endian, encode_int32)
+{
+    encode<std::int32_t>(state);
+}
+
+ZPP_BITS_BENCHMARK(endian, decode_int32)
+{
+    decode<std::int32_t>(state);
+}
+
+ZPP_BITS_BENCHMARK(endian, encode_double)
+{
+    encode<double>(state);
+}
+
+ZPP_BITS_BENCHMARK(endian, decode_double)
+{
+    decode<double>(state);
+}
+
+} // namespace benchmark_endian
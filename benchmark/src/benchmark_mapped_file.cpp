@@ -0,0 +1,73 @@
+#include "benchmark.h"
+#include <cstdio>
+#include <unistd.h>
+
+namespace benchmark_mapped_file
+{
+struct record
+{
+    std::uint64_t id;
+    std::string_view name;
+    std::span<const std::byte> payload;
+};
+
+constexpr std::size_t record_count = 0x40000;
+
+// A temporary file of about 32MB of records, which stays in the page cache.
+std::FILE * records_file()
+{
+    static auto file = [] {
+        auto [data, out] = zpp::bits::data_out();
+        std::array<std::byte, 96> payload{};
+        for (std::uint32_t i = 0; i < record_count; ++i) {
+            auto name = "record " + std::to_string(i);
+            out(record{i, name, payload}).or_throw();
+        }
+        auto file = std::tmpfile();
+        std::fwrite(data.data(), 1, data.size(), file);
+        std::fflush(file);
+        return file;
+    }();
+    return file;
+}
+
+std::size_t records_size()
+{
+    return std::size_t(lseek(fileno(records_file()), 0, SEEK_END));
+}
+
+ZPP_BITS_BENCHMARK(mapped_file, decode_read)
+{
+    auto fd = fileno(records_file());
+    auto size = records_size();
+    state.run([&] {
+        std::vector<std::byte> data(size);
+        if (pread(fd, data.data(), size, 0) != ssize_t(size)) {
+            throw std::runtime_error("read failed");
+        }
+        zpp::bits::in in(data);
+        record value;
+        for (std::size_t i = 0; i < record_count; ++i) {
+            in(value).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(value);
+    });
+    state.bytes_per_iteration(size);
+}
+
+ZPP_BITS_BENCHMARK(mapped_file, decode_mapped)
+{
+    auto fd = fileno(records_file());
+    state.run([&] {
+        auto file = zpp::bits::mapped_file::map(fd).or_throw();
+        zpp::bits::in in(file);
+        record value;
+        for (std::size_t i = 0; i < record_count; ++i) {
+            in(value).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(value);
+    });
+    state.bytes_per_iteration(records_size());
+}
+
+} // namespace benchmark_mapped_file
@@ -0,0 +1,61 @@
+#include "benchmark.h"
+#include <random>
+
+namespace benchmark_pb
+{
+constexpr std::size_t value_count = 0x100000;
+
+struct packed
+{
+    using serialize = zpp::bits::protocol<zpp::bits::pb{}>;
+    std::vector<zpp::bits::vint64_t> values;
+};
+
+// Mostly small counters and identifiers, with some large values.
+const packed & values()
+{
+    static const auto values = [] {
+        std::mt19937_64 random(0x5eed);
+        packed values;
+        for (std::size_t i = 0; i < value_count; ++i) {
+            auto roll = random() % 100;
+            values.values.push_back(
+                std::int64_t(roll < 80   ? random() % 0x80
+                             : roll < 95 ? random() % 0x4000
+                                         : random() >> (random() % 64)));
+        }
+        return values;
+    }();
+    return values;
+}
+
+ZPP_BITS_BENCHMARK(pb, packed_encode)
+{
+    auto & message = values();
+    auto [data, out] = zpp::bits::data_out(zpp::bits::no_size{});
+    state.run([&] {
+        out.reset();
+        out(message).or_throw();
+        zpp_bits_benchmark::do_not_optimize(data);
+    });
+    state.bytes_per_iteration(out.position());
+    state.items_per_iteration(value_count);
+}
+
+ZPP_BITS_BENCHMARK(pb, packed_decode)
+{
+    static const auto data = [] {
+        auto [data, out] = zpp::bits::data_out(zpp::bits::no_size{});
+        out(values()).or_throw();
+        return data;
+    }();
+    state.run([&] {
+        packed message;
+        zpp::bits::in{data, zpp::bits::no_size{}}(message).or_throw();
+        zpp_bits_benchmark::do_not_optimize(message);
+    });
+    state.bytes_per_iteration(data.size());
+    state.items_per_iteration(value_count);
+}
+
+} // namespace benchmark_pb
@@ -0,0 +1,76 @@
+#include "benchmark.h"
+
+namespace benchmark_project
+{
+struct record
+{
+    std::uint64_t id;
+    std::string name;
+    std::string description;
+    std::vector<std::string> tags;
+    std::uint32_t flags;
+    std::string owner;
+    std::vector<std::uint64_t> history;
+    double score;
+    std::string region;
+    std::optional<std::string> note;
+};
+
+constexpr std::size_t record_count = 0x4000;
+
+const std::vector<std::byte> & records()
+{
+    static const auto data = [] {
+        auto [data, out] = zpp::bits::data_out();
+        for (std::uint32_t i = 0; i < record_count; ++i) {
+            auto text = std::to_string(i);
+            out(record{i,
+                       "name of a record " + text,
+                       "a description that is long enough to allocate " + text,
+                       {"first tag " + text, "second tag " + text},
+                       i,
+                       "owner of the record " + text,
+                       {i, i + 1, i + 2},
+                       i * 0.5,
+                       "region of the record " + text,
+                       "a note attached to the record " + text})
+                .or_throw();
+        }
+        return data;
+    }();
+    return data;
+}
+
+ZPP_BITS_BENCHMARK(project, decode_all)
+{
+    auto & data = records();
+    state.run([&] {
+        zpp::bits::in in(data);
+        double total{};
+        for (std::size_t i = 0; i < record_count; ++i) {
+            record value;
+            in(value).or_throw();
+            total += value.score + double(value.id);
+        }
+        zpp_bits_benchmark::do_not_optimize(total);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(project, decode_two_members)
+{
+    auto & data = records();
+    state.run([&] {
+        zpp::bits::in in(data);
+        double total{};
+        for (std::size_t i = 0; i < record_count; ++i) {
+            record value;
+            in.project<&record::id, &record::score>(value).or_throw();
+            total += value.score + double(value.id);
+        }
+        zpp_bits_benchmark::do_not_optimize(total);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+} // namespace benchmark_project
@@ -0,0 +1,132 @@
+#include "benchmark.h"
+#include <cstdio>
+#include <unistd.h>
+
+namespace benchmark_stream
+{
+struct record
+{
+    std::uint64_t id;
+    std::string name;
+    std::vector<std::uint32_t> values;
+};
+
+constexpr std::size_t record_count = 0x10000;
+
+const std::vector<record> & values()
+{
+    static const auto values = [] {
+        std::vector<record> values;
+        for (std::uint32_t i = 0; i < record_count; ++i) {
+            values.push_back({i, std::to_string(i), {i, i + 1, i + 2, i + 3}});
+        }
+        return values;
+    }();
+    return values;
+}
+
+const std::vector<std::byte> & records()
+{
+    static const auto data = [] {
+        auto [data, out] = zpp::bits::data_out();
+        for (auto & value : values()) {
+            out(value).or_throw();
+        }
+        return data;
+    }();
+    return data;
+}
+
+// A temporary file holding the records, which stays in the page cache.
+std::FILE * records_file()
+{
+    static auto file = [] {
+        auto file = std::tmpfile();
+        auto & data = records();
+        std::fwrite(data.data(), 1, data.size(), file);
+        std::fflush(file);
+        return file;
+    }();
+    return file;
+}
+
+ZPP_BITS_BENCHMARK(stream, decode_memory)
+{
+    auto & data = records();
+    state.run([&] {
+        zpp::bits::in in(data);
+        record value;
+        for (std::size_t i = 0; i < record_count; ++i) {
+            in(value).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(value);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(stream, decode_file_descriptor)
+{
+    auto fd = fileno(records_file());
+    state.run([&] {
+        lseek(fd, 0, SEEK_SET);
+        zpp::bits::input_stream stream(fd);
+        zpp::bits::in in(stream);
+        record value;
+        for (std::size_t i = 0; i < record_count; ++i) {
+            in(value).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(value);
+    });
+    state.bytes_per_iteration(records().size());
+}
+
+ZPP_BITS_BENCHMARK(stream, decode_callable)
+{
+    auto & data = records();
+    state.run([&] {
+        std::span<const std::byte> remaining = data;
+        zpp::bits::input_stream stream([&](std::span<std::byte> bytes) {
+            auto count = std::min(bytes.size(), remaining.size());
+            std::memcpy(bytes.data(), remaining.data(), count);
+            remaining = remaining.subspan(count);
+            return count;
+        });
+        zpp::bits::in in(stream);
+        record value;
+        for (std::size_t i = 0; i < record_count; ++i) {
+            in(value).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(value);
+    });
+    state.bytes_per_iteration(data.size());
+}
+
+ZPP_BITS_BENCHMARK(stream, encode_memory)
+{
+    state.run([&] {
+        auto [data, out] = zpp::bits::data_out(zpp::bits::no_fit_size{});
+        for (auto & value : values()) {
+            out(value).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(data.data());
+    });
+    state.bytes_per_iteration(records().size());
+}
+
+ZPP_BITS_BENCHMARK(stream, encode_callable)
+{
+    auto sink = [](std::span<const std::byte> bytes) {
+        zpp_bits_benchmark::do_not_optimize(bytes.data());
+    };
+    state.run([&] {
+        zpp::bits::output_stream stream(sink);
+        zpp::bits::out out(stream);
+        for (auto & value : values()) {
+            out(value).or_throw();
+        }
+        stream.flush().or_throw();
+    });
+    state.bytes_per_iteration(records().size());
+}
+
+} // namespace benchmark_stream
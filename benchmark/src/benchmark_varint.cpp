@@ -0,0 +1,203 @@
+#include "benchmark.h"
+#include "varint_values.h"
+
+namespace benchmark_varint
+{
+using prefix_varint =
+    zpp::bits::varint<std::uint64_t, zpp::bits::varint_encoding::prefix>;
+
+template <typename Varint = zpp::bits::vuint64_t, typename SizeDistribution>
+std::vector<std::byte> encode(SizeDistribution size_distribution)
+{
+    auto [data, out] = zpp::bits::data_out();
+    for (auto value : values(size_distribution)) {
+        out(Varint{value}).or_throw();
+    }
+    return data;
+}
+
+template <zpp::bits::varint_encoding Encoding, typename SizeDistribution>
+std::vector<std::byte> encode_span(SizeDistribution size_distribution)
+{
+    auto [data, out] = zpp::bits::data_out();
+    auto span_values = values(size_distribution);
+    out(zpp::bits::varint_span<std::uint64_t, Encoding>(span_values))
+        .or_throw();
+    return data;
+}
+
+template <typename Varint = zpp::bits::vuint64_t>
+void encode(auto & state, const std::vector<std::uint64_t> & values)
+{
+    std::vector<std::byte> data;
+    zpp::bits::out out(data);
+    state.run([&] {
+        out.reset();
+        for (auto value : values) {
+            out(Varint{value}).or_throw();
+        }
+        zpp_bits_benchmark::do_not_optimize(data);
+    });
+    state.bytes_per_iteration(out.position());
+    state.items_per_iteration(value_count);
+}
+
+template <typename Varint = zpp::bits::vuint64_t>
+void decode(auto & state, const std::vector<std::byte> & data)
+{
+    state.run([&] {
+        zpp::bits::in in(data);
+        std::uint64_t sum{};
+        for (std::size_t i = 0; i < value_count; ++i) {
+            Varint value;
+            in(value).or_throw();
+            sum += value;
+        }
+        zpp_bits_benchmark::do_not_optimize(sum);
+    });
+    state.bytes_per_iteration(data.size());
+    state.items_per_iteration(value_count);
+}
+
+template <zpp::bits::varint_encoding Encoding =
+              zpp::bits::varint_encoding::normal>
+void span_encode(auto & state, const std::vector<std::uint64_t> & values)
+{
+    std::vector<std::byte> data;
+    zpp::bits::out out(data);
+    state.run([&] {
+        out.reset();
+        out(zpp::bits::varint_span<const std::uint64_t, Encoding>(values))
+            .or_throw();
+        zpp_bits_benchmark::do_not_optimize(data);
+    });
+    state.bytes_per_iteration(out.position());
+    state.items_per_iteration(value_count);
+}
+
+template <zpp::bits::varint_encoding Encoding =
+              zpp::bits::varint_encoding::normal>
+void span_decode(auto & state, const std::vector<std::byte> & data)
+{
+    std::vector<std::uint64_t> values(value_count);
+    state.run([&] {
+        zpp::bits::in{data}(
+            zpp::bits::varint_span<std::uint64_t, Encoding>(values))
+            .or_throw();
+        zpp_bits_benchmark::do_not_optimize(values);
+    });
+    state.bytes_per_iteration(data.size());
+    state.items_per_iteration(value_count);
+}
+
+ZPP_BITS_BENCHMARK(varint, decode_small)
+{
+    static const auto data = encode(small_size);
+    decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, decode_uniform)
+{
+    static const auto data = encode(uniform_size);
+    decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, decode_ten_bytes)
+{
+    static const auto data = encode(ten_bytes);
+    decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, encode_small)
+{
+    static const auto data = values(small_size);
+    encode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, encode_uniform)
+{
+    static const auto data = values(uniform_size);
+    encode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, encode_ten_bytes)
+{
+    static const auto data = values(ten_bytes);
+    encode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, span_encode_small)
+{
+    static const auto data = values(small_size);
+    span_encode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, span_encode_uniform)
+{
+    static const auto data = values(uniform_size);
+    span_encode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, span_decode_small)
+{
+    static const auto data = encode(small_size);
+    span_decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, span_decode_uniform)
+{
+    static const auto data = encode(uniform_size);
+    span_decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, prefix_encode_small)
+{
+    static const auto data = values(small_size);
+    encode<prefix_varint>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, prefix_encode_uniform)
+{
+    static const auto data = values(uniform_size);
+    encode<prefix_varint>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, prefix_decode_small)
+{
+    static const auto data = encode<prefix_varint>(small_size);
+    decode<prefix_varint>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, prefix_decode_uniform)
+{
+    static const auto data = encode<prefix_varint>(uniform_size);
+    decode<prefix_varint>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, group_span_encode_small)
+{
+    static const auto data = values(small_size);
+    span_encode<zpp::bits::varint_encoding::group>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, group_span_encode_uniform)
+{
+    static const auto data = values(uniform_size);
+    span_encode<zpp::bits::varint_encoding::group>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, group_span_decode_small)
+{
+    static const auto data =
+        encode_span<zpp::bits::varint_encoding::group>(small_size);
+    span_decode<zpp::bits::varint_encoding::group>(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, group_span_decode_uniform)
+{
+    static const auto data =
+        encode_span<zpp::bits::varint_encoding::group>(uniform_size);
+    span_decode<zpp::bits::varint_encoding::group>(state, data);
+}
+
+} // namespace benchmark_varint
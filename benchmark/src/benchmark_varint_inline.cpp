@@ -0,0 +1,64 @@
+// Varint decoding with ZPP_BITS_INLINE_DECODE_VARINT, to compare with
+// varint.decode_* which use the default out of line decoding.
+#define ZPP_BITS_INLINE_DECODE_VARINT 1
+#include "benchmark.h"
+#include "varint_values.h"
+
+namespace benchmark_varint_inline
+{
+using namespace benchmark_varint;
+
+namespace
+{
+// Gives the archives a type of their own, so that none of the templates
+// instantiated here is also instantiated without inline decoding.
+struct inline_decoding : zpp::bits::option<inline_decoding>
+{
+};
+} // namespace
+
+template <typename SizeDistribution>
+std::vector<std::byte> encode(SizeDistribution size_distribution)
+{
+    auto [data, out] = zpp::bits::data_out(inline_decoding{});
+    for (auto value : values(size_distribution)) {
+        out(zpp::bits::vuint64_t{value}).or_throw();
+    }
+    return data;
+}
+
+void decode(auto & state, const std::vector<std::byte> & data)
+{
+    state.run([&] {
+        zpp::bits::in in(data, inline_decoding{});
+        std::uint64_t sum{};
+        for (std::size_t i = 0; i < value_count; ++i) {
+            zpp::bits::vuint64_t value;
+            in(value).or_throw();
+            sum += value;
+        }
+        zpp_bits_benchmark::do_not_optimize(sum);
+    });
+    state.bytes_per_iteration(data.size());
+    state.items_per_iteration(value_count);
+}
+
+ZPP_BITS_BENCHMARK(varint, inline_decode_small)
+{
+    static const auto data = encode(small_size);
+    decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, inline_decode_uniform)
+{
+    static const auto data = encode(uniform_size);
+    decode(state, data);
+}
+
+ZPP_BITS_BENCHMARK(varint, inline_decode_ten_bytes)
+{
+    static const auto data = encode(ten_bytes);
+    decode(state, data);
+}
+
+} // namespace benchmark_varint_inline
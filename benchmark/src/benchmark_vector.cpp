@@ -0,0 +1,59 @@
+#include "benchmark.h"
+
+namespace benchmark_vector
+{
+constexpr std::size_t element_count = 0x10000;
+
+struct record
+{
+    std::uint64_t id;
+    std::string name;
+    std::vector<std::uint32_t> values;
+};
+
+template <typename Type>
+const std::vector<std::byte> & encoded()
+{
+    static const auto data = [] {
+        std::vector<Type> elements;
+        for (std::size_t i = 0; i < element_count; ++i) {
+            auto text = "an element long enough to allocate " +
+                        std::to_string(i);
+            if constexpr (std::same_as<Type, std::string>) {
+                elements.push_back(text);
+            } else {
+                elements.push_back(
+                    record{i, text, {std::uint32_t(i), std::uint32_t(i + 1)}});
+            }
+        }
+        auto [data, out] = zpp::bits::data_out();
+        out(elements).or_throw();
+        return data;
+    }();
+    return data;
+}
+
+template <typename Type>
+void decode(auto & state)
+{
+    auto & data = encoded<Type>();
+    state.run([&] {
+        std::vector<Type> elements;
+        zpp::bits::in{data}(elements).or_throw();
+        zpp_bits_benchmark::do_not_optimize(elements);
+    });
+    state.bytes_per_iteration(data.size());
+    state.items_per_iteration(element_count);
+}
+
+ZPP_BITS_BENCHMARK(vector, strings)
+{
+    decode<std::string>(state);
+}
+
+ZPP_BITS_BENCHMARK(vector, records)
+{
+    decode<record>(state);
+}
+
+} // namespace benchmark_vector
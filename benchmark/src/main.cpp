@@ -0,0 +1,19 @@
+#include "benchmark.h"
+#include <cstdlib>
+
+int main(int argc, char ** argv)
+{
+    // Usage: zpp-benchmark [filter] [milliseconds-per-benchmark]
+    std::string filter = argc > 1 ? argv[1] : "";
+    auto budget = std::chrono::milliseconds(
+        argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200);
+
+    for (auto & benchmark : zpp_bits_benchmark::registry()) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        zpp_bits_benchmark::state state(budget);
+        benchmark.function(state);
+        state.report(benchmark.name.c_str());
+    }
+}
@@ -18,4 +18,106 @@ TEST(test_bitset, sanity)
     EXPECT_EQ(i, i);
 }
 
+TEST(test_bitset, bit_order)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::bitset<12>(0b1010'0000'0011)).or_throw();
+
+    EXPECT_EQ(encode_hex(data), "030a");
+
+    std::bitset<12> i;
+    in(i).or_throw();
+    EXPECT_EQ(i, std::bitset<12>(0b1010'0000'0011));
+}
+
+TEST(test_bitset, ignores_bits_past_size)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::byte{0xff}, std::byte{0xff}).or_throw();
+
+    std::bitset<12> i;
+    in(i).or_throw();
+    EXPECT_EQ(i.count(), 12u);
+    EXPECT_TRUE(i.all());
+}
+
+TEST(test_bitset, large)
+{
+    std::bitset<65536> o;
+    for (std::size_t i = 0; i < o.size(); i += 3) {
+        o.set(i);
+    }
+    o.set(o.size() - 1);
+
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(o).or_throw();
+    EXPECT_EQ(data.size(), 65536u / 8);
+    EXPECT_EQ(std::to_integer<int>(data[0]), 0b0100'1001);
+
+    std::bitset<65536> i;
+    in(i).or_throw();
+    EXPECT_EQ(i, o);
+}
+
+TEST(test_bitset, constexpr_matches)
+{
+    constexpr auto encoded = [] {
+        std::array<std::byte, 2> data{};
+        zpp::bits::out out(data);
+        out(std::bitset<12>(0b1010'0000'0011)).or_throw();
+        return data;
+    }();
+    EXPECT_EQ(encode_hex(encoded), "030a");
+}
+
+TEST(test_bitset, vector_bool)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::vector<bool>{true, true, false, false, false, false, false,
+                          false, false, true, false, true})
+        .or_throw();
+
+    EXPECT_EQ(encode_hex(data),
+              "0c000000"
+              "030a");
+
+    std::vector<bool> i{false};
+    in(i).or_throw();
+    EXPECT_EQ(i,
+              (std::vector<bool>{true, true, false, false, false, false,
+                                 false, false, false, true, false, true}));
+}
+
+TEST(test_bitset, vector_bool_large)
+{
+    std::vector<bool> o(1001);
+    for (std::size_t i = 0; i < o.size(); i += 7) {
+        o[i] = true;
+    }
+
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(o, std::uint8_t{0x5a}).or_throw();
+    EXPECT_EQ(data.size(), sizeof(std::uint32_t) + 126 + 1);
+
+    std::vector<bool> i;
+    std::uint8_t trailer{};
+    in(i, trailer).or_throw();
+    EXPECT_EQ(i, o);
+    EXPECT_EQ(trailer, 0x5a);
+
+    zpp::bits::in skip_in(data);
+    EXPECT_EQ(skip_in.skip<std::vector<bool>>(), std::errc{});
+    EXPECT_EQ(skip_in.position(), data.size() - 1);
+}
+
+TEST(test_bitset, vector_bool_truncated)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::uint32_t{17}, std::byte{0xff}, std::byte{0xff}).or_throw();
+
+    std::vector<bool> i;
+    EXPECT_EQ(in(i), std::errc::result_out_of_range);
+    EXPECT_TRUE(i.empty());
+}
+
 } // namespace test_bitset
@@ -0,0 +1,119 @@
+#include "test.h"
+#include <bitset>
+
+namespace test_buffer
+{
+
+TEST(buffer, data_in_out)
+{
+    auto [data, in, out] = zpp::bits::data_in_out<zpp::bits::buffer<>>();
+    static_assert(std::same_as<std::remove_cvref_t<decltype(data)>,
+                               zpp::bits::buffer<>>);
+    out(std::vector{1,2,3,4}).or_throw();
+
+    EXPECT_EQ(encode_hex(data),
+              "04000000"
+              "01000000"
+              "02000000"
+              "03000000"
+              "04000000");
+
+    std::vector<int> v;
+    in(v).or_throw();
+
+    EXPECT_EQ(v, (std::vector{1,2,3,4}));
+}
+
+TEST(buffer, data_out_char)
+{
+    auto [data, out] = zpp::bits::data_out<zpp::bits::buffer<char>>();
+    out(std::string("hello")).or_throw();
+
+    EXPECT_EQ(encode_hex(data),
+              "05000000"
+              "68656c6c6f");
+}
+
+TEST(buffer, fit_keeps_capacity)
+{
+    zpp::bits::buffer data;
+    zpp::bits::out out(data);
+    out(std::array<std::uint64_t, 0x100>{}).or_throw();
+
+    EXPECT_EQ(data.size(), out.position());
+    EXPECT_GT(data.capacity(), data.size());
+
+    auto capacity = data.capacity();
+    auto pointer = data.data();
+    data.resize(1);
+    EXPECT_EQ(data.capacity(), capacity);
+    EXPECT_EQ(data.data(), pointer);
+}
+
+TEST(buffer, grows_exactly)
+{
+    zpp::bits::buffer data;
+    zpp::bits::out out(data, zpp::bits::exact_enlarger{});
+    out(std::array<std::uint64_t, 0x100>{}).or_throw();
+    EXPECT_EQ(data.capacity(), data.size());
+
+    zpp::bits::buffer resized;
+    resized.resize(10);
+    resized.resize(11);
+    EXPECT_EQ(resized.capacity(), 11u);
+}
+
+TEST(buffer, grow_preserves_content)
+{
+    zpp::bits::buffer data;
+    zpp::bits::out out(data);
+    for (int i = 0; i < 0x1000; ++i) {
+        out(i).or_throw();
+    }
+
+    zpp::bits::in in(data);
+    for (int i = 0; i < 0x1000; ++i) {
+        int value{};
+        in(value).or_throw();
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(buffer, bitset_over_garbage)
+{
+    zpp::bits::buffer data(8);
+    std::fill(data.begin(), data.end(), std::byte{0xff});
+    data.clear();
+
+    zpp::bits::out out(data);
+    out(std::bitset<16>(0x0102)).or_throw();
+    EXPECT_EQ(encode_hex(data), "0201");
+}
+
+TEST(buffer, copy_move)
+{
+    zpp::bits::buffer data;
+    zpp::bits::out{data}(std::uint32_t{0x01020304}).or_throw();
+
+    auto copy = data;
+    EXPECT_EQ(copy, data);
+
+    auto moved = std::move(copy);
+    EXPECT_EQ(moved, data);
+    EXPECT_TRUE(copy.empty());
+}
+
+constexpr auto constexpr_buffer()
+{
+    zpp::bits::buffer data;
+    auto [in, out] = zpp::bits::in_out(data);
+    out(std::tuple{1,2,3}).or_throw();
+
+    std::tuple t{0,0,0};
+    in(t).or_throw();
+    return t;
+}
+
+static_assert(constexpr_buffer() == std::tuple{1,2,3});
+
+} // namespace test_buffer
@@ -0,0 +1,207 @@
+#include "test.h"
+
+namespace test_element_views
+{
+
+struct features
+{
+    std::uint8_t kind;
+    std::span<const float> weights;
+    std::span<const std::uint64_t> ids;
+};
+
+struct custom
+{
+    constexpr auto operator()(auto & archive, auto & item, auto...) const
+    {
+        return archive(item.values);
+    }
+};
+
+// Serialized as a sized message, whose size is known after its arrays
+// were padded.
+struct message
+{
+    using serialize = zpp::bits::protocol<custom{}>;
+
+    std::vector<std::uint64_t> values;
+};
+
+bool inside(std::span<const std::byte> data, const void * pointer)
+{
+    auto byte = static_cast<const std::byte *>(pointer);
+    return data.data() <= byte && byte < data.data() + data.size();
+}
+
+TEST(element_views, alias_aligned_input)
+{
+    std::vector<float> weights{1.5f, 2.5f, 3.5f};
+    std::vector<std::uint64_t> ids{1, 2, 0x1122334455667788};
+
+    auto [data, in, out] =
+        zpp::bits::data_in_out(zpp::bits::align_arrays{});
+    out(features{7, weights, ids}).or_throw();
+
+    features decoded{};
+    in(decoded).or_throw();
+    EXPECT_EQ(in.position(), data.size());
+    EXPECT_EQ(decoded.kind, 7);
+    EXPECT_TRUE(std::ranges::equal(decoded.weights, weights));
+    EXPECT_TRUE(std::ranges::equal(decoded.ids, ids));
+    EXPECT_TRUE(inside(data, decoded.weights.data()));
+    EXPECT_TRUE(inside(data, decoded.ids.data()));
+    EXPECT_EQ(std::uintptr_t(decoded.ids.data()) % alignof(std::uint64_t),
+              0u);
+}
+
+TEST(element_views, padding)
+{
+    auto [data, out] = zpp::bits::data_out(zpp::bits::align_arrays{});
+    out(std::uint8_t{1}, std::vector<std::uint64_t>{2}).or_throw();
+    EXPECT_EQ(encode_hex(data),
+              "01"
+              "01000000"
+              "000000"
+              "0200000000000000");
+    EXPECT_EQ(zpp::bits::size_of<zpp::bits::align_arrays>(
+                  std::uint8_t{1}, std::vector<std::uint64_t>{2})
+                  .or_throw(),
+              data.size());
+
+    zpp::bits::in in(data, zpp::bits::align_arrays{});
+    std::uint8_t first{};
+    std::vector<std::uint64_t> second;
+    in(first, second).or_throw();
+    EXPECT_EQ(second, (std::vector<std::uint64_t>{2}));
+
+    // Byte arrays and unaligned elements are not padded.
+    auto [bytes, bytes_out] =
+        zpp::bits::data_out(zpp::bits::align_arrays{});
+    bytes_out(std::uint8_t{1}, std::string("ab")).or_throw();
+    EXPECT_EQ(bytes.size(), 1u + 4u + 2u);
+}
+
+TEST(element_views, sized_message)
+{
+    for (std::size_t count : {2, 20, 200}) {
+        message sent;
+        for (std::size_t i = 0; i < count; ++i) {
+            sent.values.push_back(i * 0x0101010101010101);
+        }
+
+        auto [data, in, out] = zpp::bits::data_in_out(
+            zpp::bits::align_arrays{}, zpp::bits::size_varint{});
+        out(std::uint8_t{1}, sent).or_throw();
+        auto size = zpp::bits::size_of<zpp::bits::align_arrays,
+                                       zpp::bits::size_varint>(
+            std::uint8_t{1}, sent);
+        EXPECT_EQ(size.or_throw(), data.size());
+
+        std::uint8_t kind{};
+        message received;
+        in(kind, received).or_throw();
+        EXPECT_EQ(in.position(), data.size());
+        EXPECT_EQ(received.values, sent.values);
+    }
+}
+
+TEST(element_views, misaligned)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::uint8_t{1}, std::vector<std::uint64_t>{2, 3}).or_throw();
+
+    std::uint8_t first{};
+    std::span<const std::uint64_t> second;
+    zpp::bits::in in(data);
+    EXPECT_EQ(in(first, second), std::errc::bad_address);
+
+    std::array<std::uint64_t, 4> storage{};
+    std::span<const std::uint64_t> third;
+    zpp::bits::in copy_in(data, zpp::bits::copy_misaligned{storage});
+    copy_in(first, second).or_throw();
+    EXPECT_EQ(second.data(), storage.data());
+    EXPECT_EQ(second.size(), 2u);
+    EXPECT_EQ(second[1], 3u);
+
+    // The input is left untouched, and later views use the rest of the
+    // storage.
+    copy_in.reset();
+    copy_in(first, third).or_throw();
+    EXPECT_EQ(third.data(), storage.data() + 2);
+    EXPECT_EQ(third[0], 2u);
+    EXPECT_EQ(second[0], 2u);
+
+    std::array<std::uint64_t, 1> short_storage{};
+    zpp::bits::in short_in(data, zpp::bits::copy_misaligned{short_storage});
+    EXPECT_EQ(short_in(first, second), std::errc::no_buffer_space);
+}
+
+TEST(element_views, truncated)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::uint32_t>{1, 2, 3}).or_throw();
+    data.resize(data.size() - 1);
+
+    std::span<const std::uint32_t> view;
+    zpp::bits::in in(data);
+    EXPECT_EQ(in(view), std::errc::result_out_of_range);
+    EXPECT_EQ(in.shortfall(), 1u);
+}
+
+TEST(element_views, unsized)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::uint32_t{1},
+        zpp::bits::unsized(std::vector<std::uint32_t>{3, 4, 5}))
+        .or_throw();
+
+    std::uint32_t first{};
+    std::span<const std::uint32_t> rest;
+    in(first, zpp::bits::unsized(rest)).or_throw();
+    ASSERT_EQ(rest.size(), 3u);
+    EXPECT_EQ(rest[2], 5u);
+    EXPECT_TRUE(inside(data, rest.data()));
+}
+
+TEST(element_views, streams)
+{
+    std::vector<double> values{1, 2, 3};
+    message sent{{4, 5}};
+    std::vector<std::byte> sink;
+    {
+        zpp::bits::output_stream stream(
+            [&](std::span<const std::byte> bytes) {
+                sink.insert(sink.end(), bytes.begin(), bytes.end());
+            },
+            16);
+        zpp::bits::out out(stream, zpp::bits::align_arrays{});
+        out(std::uint8_t{1}, std::string("abc"), values, values, sent)
+            .or_throw();
+    }
+
+    auto [expected, out] = zpp::bits::data_out(zpp::bits::align_arrays{});
+    out(std::uint8_t{1}, std::string("abc"), values, values, sent)
+        .or_throw();
+    EXPECT_EQ(encode_hex(sink), encode_hex(expected));
+
+    std::span<const std::byte> remaining = sink;
+    zpp::bits::input_stream stream(
+        [&](std::span<std::byte> bytes) {
+            auto count = std::min<std::size_t>(bytes.size(), 5);
+            count = std::min(count, remaining.size());
+            std::copy_n(remaining.begin(), count, bytes.begin());
+            remaining = remaining.subspan(count);
+            return count;
+        },
+        16);
+    zpp::bits::in in(stream, zpp::bits::align_arrays{});
+    std::uint8_t first{};
+    std::string text;
+    std::vector<double> second, third;
+    message received;
+    in(first, text, second, third, received).or_throw();
+    EXPECT_EQ(third, values);
+    EXPECT_EQ(received.values, sent.values);
+}
+
+} // namespace test_element_views
@@ -134,4 +134,162 @@ TEST(test_endian, little_in)
     EXPECT_EQ(ints.i64, 0x123456789abcdef0u);
 }
 
+enum class code : std::uint16_t
+{
+    first = 0x0102,
+    second = 0x0304,
+};
+
+template <typename Type>
+std::vector<Type> make_elements(std::size_t count)
+{
+    std::vector<Type> elements;
+    for (std::size_t i = 0; i < count; ++i) {
+        elements.push_back(Type(0x0102030405060708ull * (i + 1)));
+    }
+    return elements;
+}
+
+template <typename Type>
+void expect_bulk_matches_elementwise()
+{
+    for (std::size_t count = 0; count < 70; ++count) {
+        auto elements = make_elements<Type>(count);
+
+        auto [expected, out_expected] = data_out(zpp::bits::endian::big{});
+        out_expected(std::uint32_t(count)).or_throw();
+        for (auto element : elements) {
+            out_expected(element).or_throw();
+        }
+
+        auto [data, in, out] = data_in_out(zpp::bits::endian::big{});
+        out(elements).or_throw();
+        EXPECT_EQ(data, expected);
+
+        std::vector<Type> decoded;
+        in(decoded).or_throw();
+        EXPECT_EQ(decoded, elements);
+    }
+}
+
+TEST(test_endian, bulk_swapped_containers)
+{
+    expect_bulk_matches_elementwise<std::uint16_t>();
+    expect_bulk_matches_elementwise<std::int32_t>();
+    expect_bulk_matches_elementwise<std::uint64_t>();
+    expect_bulk_matches_elementwise<double>();
+}
+
+TEST(test_endian, bulk_swapped_arrays)
+{
+    auto [data, in, out] = data_in_out(zpp::bits::endian::big{});
+    std::uint32_t array[3] = {0x01020304, 0x05060708, 0x090a0b0c};
+    out(array,
+        std::array<code, 2>{code::first, code::second},
+        std::vector<code>{code::second})
+        .or_throw();
+
+    EXPECT_EQ(encode_hex(data),
+              "01020304"
+              "05060708"
+              "090a0b0c"
+              "0102"
+              "0304"
+              "00000001"
+              "0304");
+
+    std::uint32_t decoded_array[3]{};
+    std::array<code, 2> codes{};
+    std::vector<code> more_codes;
+    in(decoded_array, codes, more_codes).or_throw();
+    EXPECT_EQ(decoded_array[0], 0x01020304u);
+    EXPECT_EQ(decoded_array[2], 0x090a0b0cu);
+    EXPECT_EQ(codes, (std::array<code, 2>{code::first, code::second}));
+    EXPECT_EQ(more_codes, (std::vector<code>{code::second}));
+}
+
+TEST(test_endian, bulk_swapped_truncated)
+{
+    auto [data, in, out] = data_in_out(zpp::bits::endian::big{});
+    out(std::vector<std::uint32_t>{1, 2, 3}).or_throw();
+    data.resize(data.size() - 1);
+
+    std::vector<std::uint32_t> decoded;
+    EXPECT_EQ(in(decoded), std::errc::result_out_of_range);
+}
+
+TEST(test_endian, bulk_swapped_segmented_and_streaming)
+{
+    auto elements = make_elements<std::uint64_t>(100);
+
+    auto [expected, out_expected] = data_out(zpp::bits::endian::big{});
+    out_expected(elements).or_throw();
+
+    zpp::bits::chunk_pool pool(60);
+    zpp::bits::segmented_buffer segmented(pool);
+    zpp::bits::out out(segmented, zpp::bits::endian::big{});
+    out(elements).or_throw();
+
+    std::vector<std::byte> flattened;
+    for (auto segment : segmented.segments()) {
+        auto bytes = std::as_bytes(segment);
+        flattened.insert(flattened.end(), bytes.begin(), bytes.end());
+    }
+    EXPECT_EQ(flattened, expected);
+
+    std::span<const std::byte> remaining = expected;
+    zpp::bits::input_stream stream(
+        [&](std::span<std::byte> bytes) {
+            auto count = std::min<std::size_t>({bytes.size(), remaining.size(), 13});
+            std::copy_n(remaining.begin(), count, bytes.begin());
+            remaining = remaining.subspan(count);
+            return count;
+        },
+        20);
+    zpp::bits::in in(stream, zpp::bits::endian::big{});
+    std::vector<std::uint64_t> decoded;
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded, elements);
+}
+
+TEST(test_endian, reverse_element_bytes_kernels)
+{
+    std::vector<unsigned char> source(101);
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<unsigned char>(i);
+    }
+
+    auto check = [&]<std::size_t Size>(auto kernel) {
+        for (std::size_t count = 0; count <= source.size() / Size; ++count) {
+            std::vector<unsigned char> expected(count * Size);
+            std::vector<unsigned char> destination(count * Size);
+            zpp::bits::kernels::reverse_element_bytes_portable<Size>(
+                expected.data(), source.data(), count);
+            kernel(destination.data(), source.data(), count);
+            EXPECT_EQ(destination, expected);
+        }
+    };
+
+    std::vector<unsigned char> swapped(4);
+    zpp::bits::kernels::reverse_element_bytes_portable<4>(
+        swapped.data(), source.data(), 1);
+    EXPECT_EQ(swapped, (std::vector<unsigned char>{3, 2, 1, 0}));
+
+#if ZPP_BITS_X86_KERNELS
+    if (__builtin_cpu_supports("ssse3")) {
+        check.operator()<2>(zpp::bits::kernels::reverse_element_bytes_ssse3<2>);
+        check.operator()<4>(zpp::bits::kernels::reverse_element_bytes_ssse3<4>);
+        check.operator()<8>(zpp::bits::kernels::reverse_element_bytes_ssse3<8>);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        check.operator()<2>(zpp::bits::kernels::reverse_element_bytes_avx2<2>);
+        check.operator()<4>(zpp::bits::kernels::reverse_element_bytes_avx2<4>);
+        check.operator()<8>(zpp::bits::kernels::reverse_element_bytes_avx2<8>);
+    }
+#endif
+    check.operator()<8>([](auto destination, auto source, auto count) {
+        zpp::bits::kernels::reverse_element_bytes<8>(destination, source, count);
+    });
+}
+
 } // namespace test_endian
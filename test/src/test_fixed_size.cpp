@@ -0,0 +1,121 @@
+#include "test.h"
+#include <bitset>
+
+namespace test_fixed_size
+{
+
+struct padded
+{
+    char c;
+    int i;
+};
+
+struct record
+{
+    std::uint16_t id;
+    std::array<padded, 2> items;
+    std::bitset<12> flags;
+    double value;
+};
+
+static_assert(zpp::bits::traits::fixed_size<padded>() == 5);
+static_assert(zpp::bits::traits::fixed_size<record>() == 2 + 10 + 2 + 8);
+static_assert(zpp::bits::traits::fixed_size<std::tuple<char, short>>() ==
+              3);
+static_assert(zpp::bits::traits::fixed_size<zpp::bits::vint32_t>() ==
+              zpp::bits::unbounded_size);
+static_assert(zpp::bits::traits::fixed_size<std::optional<int>>() ==
+              zpp::bits::unbounded_size);
+static_assert(zpp::bits::traits::fixed_size<std::variant<int, char>>() ==
+              zpp::bits::unbounded_size);
+
+record make_record()
+{
+    return {0x1122, {{{'a', 0x33445566}, {'b', 0x778899aa}}}, 0xabc, 1.5};
+}
+
+TEST(fixed_size, out_matches_members)
+{
+    auto value = make_record();
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(value.id,
+                 value.items[0].c,
+                 value.items[0].i,
+                 value.items[1].c,
+                 value.items[1].i,
+                 value.flags,
+                 value.value)
+        .or_throw();
+
+    EXPECT_EQ(encode_hex(data), encode_hex(expected));
+    EXPECT_EQ(data.size(), zpp::bits::traits::fixed_size<record>());
+}
+
+TEST(fixed_size, round_trip)
+{
+    auto value = make_record();
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(value, value).or_throw();
+
+    record first{}, second{};
+    in(first, second).or_throw();
+    for (auto & decoded : {first, second}) {
+        EXPECT_EQ(decoded.id, value.id);
+        EXPECT_EQ(decoded.items[1].c, value.items[1].c);
+        EXPECT_EQ(decoded.items[1].i, value.items[1].i);
+        EXPECT_EQ(decoded.flags, value.flags);
+        EXPECT_EQ(decoded.value, value.value);
+    }
+    EXPECT_EQ(in.position(), out.position());
+}
+
+TEST(fixed_size, endian_swapped)
+{
+    padded value{'x', 0x01020304};
+    auto [data, in, out] = zpp::bits::data_in_out(zpp::bits::endian::swapped{});
+    out(value).or_throw();
+    EXPECT_EQ(encode_hex(data), "7801020304");
+
+    padded decoded{};
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.c, value.c);
+    EXPECT_EQ(decoded.i, value.i);
+}
+
+TEST(fixed_size, out_of_range)
+{
+    std::array<std::byte, zpp::bits::traits::fixed_size<record>() - 1> data{};
+    zpp::bits::out out(data);
+    EXPECT_EQ(out(make_record()), std::errc::result_out_of_range);
+    EXPECT_EQ(out.position(), 0u);
+
+    zpp::bits::in in(data);
+    record decoded{};
+    EXPECT_EQ(in(decoded), std::errc::result_out_of_range);
+    EXPECT_EQ(in.position(), 0u);
+}
+
+TEST(fixed_size, sizer)
+{
+    EXPECT_EQ(zpp::bits::size_of(make_record(), padded{}).or_throw(),
+              zpp::bits::traits::fixed_size<record>() + 5);
+}
+
+constexpr auto constexpr_round_trip()
+{
+    std::array<std::byte, 10> data{};
+    zpp::bits::out out(data);
+    out(padded{'a', 1}, padded{'b', 2}).or_throw();
+
+    padded first{}, second{};
+    zpp::bits::in in(data);
+    in(first, second).or_throw();
+    return first.i + second.i;
+}
+
+static_assert(constexpr_round_trip() == 3);
+
+} // namespace test_fixed_size
@@ -0,0 +1,139 @@
+#include "test.h"
+#include <ranges>
+
+namespace test_indexed
+{
+
+struct record
+{
+    std::uint32_t key;
+    std::string name;
+};
+
+std::vector<record> make_records()
+{
+    std::vector<record> records;
+    for (std::uint32_t i = 0; i < 50; ++i) {
+        records.push_back({i * 2, std::string(i % 7, 'a' + char(i % 26))});
+    }
+    return records;
+}
+
+struct message
+{
+    zpp::bits::indexed<std::vector<record>> records;
+    std::string trailer;
+};
+
+struct message_view
+{
+    zpp::bits::indexed_view<record> records;
+    std::string trailer;
+};
+
+TEST(indexed, encoding)
+{
+    zpp::bits::indexed<std::vector<std::string>> value{
+        std::vector<std::string>{"a", "bcd"}};
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+    EXPECT_EQ(encode_hex(data),
+              "02000000"
+              "05000000"
+              "0c000000"
+              "0100000061"
+              "03000000626364");
+    EXPECT_EQ(zpp::bits::size_of(value).or_throw(), data.size());
+}
+
+TEST(indexed, round_trip)
+{
+    auto records = make_records();
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(message{records, "end"}).or_throw();
+
+    message decoded{};
+    in(decoded).or_throw();
+    ASSERT_EQ(decoded.records.size(), records.size());
+    EXPECT_EQ(decoded.records[49].name, records[49].name);
+    EXPECT_EQ(decoded.trailer, "end");
+    EXPECT_EQ(in.position(), data.size());
+}
+
+TEST(indexed, view)
+{
+    auto records = make_records();
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(message{records, "end"}).or_throw();
+
+    message_view view{};
+    in(view).or_throw();
+    EXPECT_EQ(view.trailer, "end");
+    ASSERT_EQ(view.records.size(), records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        auto value = view.records.at(i).or_throw();
+        EXPECT_EQ(value.key, records[i].key);
+        EXPECT_EQ(value.name, records[i].name);
+    }
+    EXPECT_EQ(view.records.at(50).error(), std::errc::result_out_of_range);
+
+    // Binary search by key.
+    auto indices = std::views::iota(std::size_t{}, view.records.size());
+    auto found = std::ranges::partition_point(indices, [&](auto index) {
+        return view.records.at(index).or_throw().key < 64;
+    });
+    EXPECT_EQ(*found, 32u);
+
+    // Views are written back as they were read.
+    auto [copy, copy_out] = zpp::bits::data_out();
+    copy_out(view).or_throw();
+    EXPECT_EQ(copy, data);
+}
+
+TEST(indexed, endian_swapped)
+{
+    auto records = make_records();
+    auto [data, in, out] = zpp::bits::data_in_out(zpp::bits::endian::swapped{});
+    out(message{records, "end"}).or_throw();
+
+    zpp::bits::in view_in(data, zpp::bits::endian::swapped{});
+    zpp::bits::indexed_view<record, zpp::bits::endian::swapped> view;
+    view_in(view).or_throw();
+    EXPECT_EQ(view.at(10).or_throw().key, 20u);
+}
+
+TEST(indexed, errors)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(zpp::bits::indexed<std::vector<std::string>>{
+            std::vector<std::string>{"a", "b"}})
+        .or_throw();
+
+    auto truncated = std::span{data}.first(data.size() - 1);
+    zpp::bits::in in(truncated);
+    zpp::bits::indexed_view<std::string> view;
+    EXPECT_EQ(in(view), std::errc::result_out_of_range);
+
+    // The first end offset past the second.
+    data[4] = std::byte{0x20};
+    zpp::bits::in corrupt_in(data);
+    corrupt_in(view).or_throw();
+    EXPECT_EQ(view.at(0).error(), std::errc::illegal_byte_sequence);
+    EXPECT_EQ(view.at(1).error(), std::errc::illegal_byte_sequence);
+
+    // The first element ends before its slot does.
+    data[4] = std::byte{0x05};
+    data[12] = std::byte{0x00};
+    zpp::bits::in trailing_in(data);
+    trailing_in(view).or_throw();
+    EXPECT_EQ(view.at(0).error(), std::errc::bad_message);
+    EXPECT_EQ(view.at(1).or_throw(), "b");
+
+    std::array<std::byte, 16> small{};
+    zpp::bits::out small_out(small);
+    EXPECT_EQ(small_out(zpp::bits::indexed<std::vector<std::string>>{
+                  std::vector<std::string>{"abc", "def"}}),
+              std::errc::result_out_of_range);
+}
+
+} // namespace test_indexed
@@ -0,0 +1,284 @@
+#include "test.h"
+#include <cstdio>
+#include <sstream>
+
+using namespace zpp::bits::literals;
+
+namespace test_input_stream
+{
+
+// Hands out at most chunk bytes per call, to exercise refills.
+struct source
+{
+    std::span<const std::byte> data;
+    std::size_t chunk{};
+    std::vector<std::size_t> reads{};
+
+    std::size_t operator()(std::span<std::byte> bytes)
+    {
+        auto count = std::min({bytes.size(), data.size(), chunk});
+        std::copy_n(data.begin(), count, bytes.begin());
+        data = data.subspan(count);
+        reads.push_back(count);
+        return count;
+    }
+};
+
+struct person
+{
+    std::string name;
+    std::uint64_t id;
+    std::vector<std::uint32_t> numbers;
+    std::optional<std::map<int, std::string>> extra;
+    zpp::bits::vint64_t score;
+};
+
+person make_person()
+{
+    person value{"a long enough name", 0x1122334455667788, {}, {}, -1};
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        value.numbers.push_back(i);
+    }
+    value.extra = std::map<int, std::string>{{1, "one"}, {2, "two"}};
+    return value;
+}
+
+void expect_person(const person & decoded)
+{
+    auto value = make_person();
+    EXPECT_EQ(decoded.name, value.name);
+    EXPECT_EQ(decoded.id, value.id);
+    EXPECT_EQ(decoded.numbers, value.numbers);
+    EXPECT_EQ(decoded.extra, value.extra);
+    EXPECT_EQ(decoded.score, value.score);
+}
+
+TEST(input_stream, matches_vector)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_person(), std::variant<int, char>{'c'}).or_throw();
+
+    for (std::size_t chunk : {1, 3, 16, 1000}) {
+        source input{data, chunk};
+        zpp::bits::input_stream stream(input, 16);
+        zpp::bits::in in(stream);
+
+        person decoded;
+        std::variant<int, char> tag;
+        in(decoded, tag).or_throw();
+        expect_person(decoded);
+        EXPECT_EQ(tag, (std::variant<int, char>{'c'}));
+        EXPECT_TRUE(stream.exhausted());
+    }
+}
+
+TEST(input_stream, large_bytes_bypass_window)
+{
+    std::vector<char> payload(1000, 'x');
+    auto [data, out] = zpp::bits::data_out();
+    out(std::uint8_t{1}, payload, std::uint8_t{2}).or_throw();
+
+    source input{data, 0x10000};
+    zpp::bits::input_stream stream(input, 64);
+    zpp::bits::in in(stream);
+
+    std::uint8_t first{}, last{};
+    std::vector<char> decoded;
+    in(first, decoded, last).or_throw();
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(decoded, payload);
+    EXPECT_EQ(last, 2);
+    EXPECT_EQ(input.reads, (std::vector<std::size_t>{64, 941, 1}));
+}
+
+TEST(input_stream, records)
+{
+    auto [data, out] = zpp::bits::data_out();
+    for (int i = 0; i < 100; ++i) {
+        out(i, std::to_string(i)).or_throw();
+    }
+
+    source input{data, 7};
+    zpp::bits::input_stream stream(input, 32);
+    int count = 0;
+    while (!stream.exhausted()) {
+        zpp::bits::in in(stream);
+        int i{};
+        std::string text;
+        in(i, text).or_throw();
+        EXPECT_EQ(i, count);
+        EXPECT_EQ(text, std::to_string(count));
+        ++count;
+    }
+    EXPECT_EQ(count, 100);
+    EXPECT_EQ(stream.offset() + stream.committed(), data.size());
+}
+
+struct padded
+{
+    char c;
+    int i;
+};
+
+TEST(input_stream, grows_for_fixed_size_items)
+{
+    std::array<padded, 10> value{};
+    value[9] = {'z', 9};
+    auto [data, out] = zpp::bits::data_out();
+    out(std::byte{1}, value).or_throw();
+
+    source input{data, 5};
+    zpp::bits::input_stream stream(input, 8);
+    zpp::bits::in in(stream);
+    std::byte first{};
+    std::array<padded, 10> decoded{};
+    in(first, decoded).or_throw();
+    EXPECT_EQ(decoded[9].c, 'z');
+    EXPECT_EQ(decoded[9].i, 9);
+}
+
+TEST(input_stream, truncated)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_person()).or_throw();
+    data.resize(data.size() - 1);
+
+    source input{data, 16};
+    zpp::bits::input_stream stream(input, 16);
+    zpp::bits::in in(stream);
+    person decoded;
+    EXPECT_EQ(in(decoded), std::errc::result_out_of_range);
+
+    std::vector<char> payload(100);
+    auto [bytes, bytes_out] = zpp::bits::data_out();
+    bytes_out(payload).or_throw();
+    bytes.resize(bytes.size() - 1);
+
+    source bytes_input{bytes, 16};
+    zpp::bits::input_stream bytes_stream(bytes_input, 16);
+    zpp::bits::in bytes_in(bytes_stream);
+    EXPECT_EQ(bytes_in(payload), std::errc::result_out_of_range);
+}
+
+struct pb_inner
+{
+    std::string text;
+};
+
+auto serialize(const pb_inner &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+struct pb_outer
+{
+    zpp::bits::vint32_t id;
+    pb_inner inner;
+    std::vector<pb_inner> inners;
+};
+
+auto serialize(const pb_outer &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+TEST(input_stream, pb)
+{
+    pb_outer value{1337, {std::string(300, 'i')}, {{"a"}, {"b"}}};
+    auto [data, out] = zpp::bits::data_out();
+    out(value, value).or_throw();
+
+    source input{data, 10};
+    zpp::bits::input_stream stream(input, 16);
+    zpp::bits::in in(stream);
+    pb_outer first, second;
+    in(first, second).or_throw();
+    for (auto & decoded : {first, second}) {
+        EXPECT_EQ(decoded.id, 1337);
+        EXPECT_EQ(decoded.inner.text, value.inner.text);
+        ASSERT_EQ(decoded.inners.size(), 2u);
+        EXPECT_EQ(decoded.inners[1].text, "b");
+    }
+
+    auto [varint_data, varint_out] =
+        zpp::bits::data_out(zpp::bits::size_varint{});
+    varint_out(value).or_throw();
+
+    source varint_input{varint_data, 10};
+    zpp::bits::input_stream varint_stream(varint_input, 16);
+    zpp::bits::in varint_in(varint_stream, zpp::bits::size_varint{});
+    pb_outer decoded;
+    varint_in(decoded).or_throw();
+    EXPECT_EQ(decoded.inner.text, value.inner.text);
+}
+
+TEST(input_stream, untrusted_sizes)
+{
+    // A pb message whose length prefix claims 2GiB.
+    auto data = "12ffffffff07"_decode_hex;
+
+    source input{data, 16};
+    zpp::bits::input_stream stream(input, 16);
+    zpp::bits::in in(stream);
+    pb_outer decoded;
+    EXPECT_EQ(in(decoded), std::errc::message_size);
+    EXPECT_EQ(stream.capacity(), 16u);
+
+    source limited_input{data, 16};
+    zpp::bits::input_stream limited_stream(limited_input, 16, 1u << 30);
+    zpp::bits::in limited_in(limited_stream, zpp::bits::alloc_limit<1024>{});
+    EXPECT_EQ(limited_in(decoded), std::errc::message_size);
+    EXPECT_EQ(limited_stream.capacity(), 16u);
+
+    // A vector<bool> whose size prefix claims 2^32 - 1 bits.
+    auto bits = "ffffffff00"_decode_hex;
+
+    source bits_input{bits, 16};
+    zpp::bits::input_stream bits_stream(bits_input, 16);
+    zpp::bits::in bits_in(bits_stream);
+    std::vector<bool> flags;
+    EXPECT_EQ(bits_in(flags), std::errc::message_size);
+    EXPECT_EQ(bits_stream.capacity(), 16u);
+}
+
+TEST(input_stream, istream)
+{
+    auto [data, out] = zpp::bits::data_out<char>();
+    out(make_person()).or_throw();
+
+    std::istringstream stream_data(std::string(data.begin(), data.end()));
+    zpp::bits::input_stream stream(stream_data, 16);
+    zpp::bits::in in(stream);
+    person decoded;
+    in(decoded).or_throw();
+    expect_person(decoded);
+    EXPECT_TRUE(stream.exhausted());
+}
+
+TEST(input_stream, file_and_file_descriptor)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_person()).or_throw();
+
+    auto file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fwrite(data.data(), 1, data.size(), file), data.size());
+
+    {
+        std::rewind(file);
+        zpp::bits::input_stream stream(file, 16);
+        zpp::bits::in in(stream);
+        person decoded;
+        in(decoded).or_throw();
+        expect_person(decoded);
+        EXPECT_TRUE(stream.exhausted());
+    }
+
+    {
+        std::fflush(file);
+        ASSERT_EQ(lseek(fileno(file), 0, SEEK_SET), 0);
+        zpp::bits::input_stream stream(fileno(file), 16);
+        zpp::bits::in in(stream);
+        person decoded;
+        in(decoded).or_throw();
+        expect_person(decoded);
+        EXPECT_TRUE(stream.exhausted());
+    }
+    std::fclose(file);
+}
+
+} // namespace test_input_stream
@@ -0,0 +1,169 @@
+#include "test.h"
+
+namespace test_lazy
+{
+
+struct payload
+{
+    inline static int decodes = 0;
+
+    std::string text;
+    std::vector<int> values;
+
+    constexpr static auto serialize(auto & archive, auto & self)
+    {
+        if constexpr (std::remove_cvref_t<decltype(archive)>::kind() ==
+                      zpp::bits::kind::in) {
+            ++decodes;
+        }
+        return archive(self.text, self.values);
+    }
+};
+
+struct message
+{
+    std::uint32_t id;
+    zpp::bits::lazy<payload> body;
+    std::string trailer;
+};
+
+TEST(lazy, decodes_on_access)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(message{1, payload{"text", {1, 2, 3}}, "end"}).or_throw();
+
+    // Same encoding as a sized byte array of the payload.
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(std::uint32_t{1},
+                 zpp::bits::to_vector_exact(payload{"text", {1, 2, 3}})
+                     .or_throw(),
+                 std::string("end"))
+        .or_throw();
+    EXPECT_EQ(encode_hex(data), encode_hex(expected));
+
+    payload::decodes = 0;
+    message decoded{};
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.id, 1u);
+    EXPECT_EQ(decoded.trailer, "end");
+    EXPECT_FALSE(decoded.body.decoded());
+    EXPECT_EQ(payload::decodes, 0);
+
+    auto & body = decoded.body.get().or_throw();
+    EXPECT_EQ(body.text, "text");
+    EXPECT_EQ(body.values, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(&decoded.body.get().or_throw(), &body);
+    EXPECT_EQ(payload::decodes, 1);
+}
+
+TEST(lazy, reencodes_original_bytes)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(message{1, payload{"text", {1}}, "end"}).or_throw();
+
+    message decoded{};
+    in(decoded).or_throw();
+    EXPECT_FALSE(decoded.body.modified());
+    decoded.id = 2;
+
+    payload::decodes = 0;
+    auto [copy, copy_out] = zpp::bits::data_out();
+    copy_out(decoded).or_throw();
+    EXPECT_EQ(payload::decodes, 0);
+    EXPECT_EQ(copy.size(), data.size());
+    EXPECT_TRUE(std::equal(copy.begin() + 4, copy.end(), data.begin() + 4));
+
+    decoded.body.modify().or_throw().text = "changed";
+    EXPECT_TRUE(decoded.body.modified());
+    auto [modified, modified_out] = zpp::bits::data_out();
+    modified_out(decoded).or_throw();
+
+    zpp::bits::in modified_in(modified);
+    message result{};
+    modified_in(result).or_throw();
+    EXPECT_EQ(result.body.get().or_throw().text, "changed");
+    EXPECT_EQ(result.body.get().or_throw().values, (std::vector<int>{1}));
+    EXPECT_EQ(result.trailer, "end");
+}
+
+TEST(lazy, errors)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::byte>{std::byte{0xff}}).or_throw();
+
+    zpp::bits::in in(data);
+    zpp::bits::lazy<std::string> value;
+    in(value).or_throw();
+    EXPECT_EQ(value.encoded().size(), 1u);
+    EXPECT_EQ(value.get().error(), std::errc::result_out_of_range);
+    EXPECT_FALSE(value.decoded());
+
+    data.resize(data.size() - 1);
+    zpp::bits::in truncated(data);
+    EXPECT_EQ(truncated(value), std::errc::result_out_of_range);
+
+    // Bytes left over after the value are an error as well.
+    auto [trailing, trailing_out] = zpp::bits::data_out();
+    trailing_out(std::vector<std::byte>{std::byte{1}, std::byte{0},
+                                        std::byte{0xff}})
+        .or_throw();
+    zpp::bits::in trailing_in(trailing);
+    zpp::bits::lazy<std::uint16_t> number;
+    trailing_in(number).or_throw();
+    EXPECT_EQ(number.get().error(), std::errc::bad_message);
+    EXPECT_FALSE(number.decoded());
+}
+
+TEST(lazy, options)
+{
+    zpp::bits::lazy<std::string, zpp::bits::size1b> value = std::string("abc");
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(value).or_throw();
+    EXPECT_EQ(encode_hex(data), "0400000003616263");
+
+    zpp::bits::lazy<std::string, zpp::bits::size1b> decoded;
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.get().or_throw(), "abc");
+}
+
+TEST(lazy, output_archives)
+{
+    message value{1, payload{std::string(100, 'x'), {1, 2, 3}}, "end"};
+
+    auto [expected, out_expected] = zpp::bits::data_out(zpp::bits::size_varint{});
+    out_expected(std::uint32_t{1},
+                 zpp::bits::to_vector_exact(payload{std::string(100, 'x'),
+                                                    {1, 2, 3}})
+                     .or_throw(),
+                 std::string("end"))
+        .or_throw();
+
+    auto [data, out] = zpp::bits::data_out(zpp::bits::size_varint{});
+    out(value).or_throw();
+    EXPECT_EQ(encode_hex(data), encode_hex(expected));
+    EXPECT_EQ(zpp::bits::size_of<zpp::bits::size_varint>(value).or_throw(),
+              expected.size());
+
+    std::array<std::byte, 256> fixed{};
+    zpp::bits::out fixed_out(fixed, zpp::bits::size_varint{});
+    fixed_out(value).or_throw();
+    EXPECT_EQ(encode_hex(std::span{fixed}.first(fixed_out.position())),
+              encode_hex(expected));
+
+    std::vector<std::byte> sink;
+    {
+        zpp::bits::output_stream stream(
+            [&](std::span<const std::byte> bytes) {
+                sink.insert(sink.end(), bytes.begin(), bytes.end());
+            },
+            16);
+        zpp::bits::out stream_out(stream, zpp::bits::size_varint{});
+        stream_out(value).or_throw();
+    }
+    EXPECT_EQ(encode_hex(sink), encode_hex(expected));
+
+    std::array<std::byte, 64> small{};
+    EXPECT_EQ(zpp::bits::out{small}(value), std::errc::result_out_of_range);
+}
+
+} // namespace test_lazy
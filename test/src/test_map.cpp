@@ -1,5 +1,6 @@
 #include "test.h"
 #include <map>
+#include <unordered_map>
 
 TEST(map, integer)
 {
@@ -53,3 +54,78 @@ TEST(map, string)
             {"1"s, "1"s}, {"2"s, "2"s}, {"3"s, "3"s}, {"4"s, "4"s}}));
 }
 
+
+TEST(map, unsorted_and_duplicate_keys)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::uint32_t{4},
+        std::pair{3, std::string("c")},
+        std::pair{1, std::string("a")},
+        std::pair{3, std::string("duplicate")},
+        std::pair{2, std::string("b")})
+        .or_throw();
+
+    std::map<int, std::string> s{{5, "e"}};
+    in(s).or_throw();
+
+    EXPECT_EQ(s, (std::map<int, std::string>{{1, "a"}, {2, "b"}, {3, "c"}}));
+    EXPECT_EQ(in.position(), data.size());
+}
+
+TEST(map, multimap)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::multimap<int, int>{{1, 1}, {1, 2}, {2, 3}}).or_throw();
+
+    std::multimap<int, int> s;
+    in(s).or_throw();
+
+    EXPECT_EQ(s, (std::multimap<int, int>{{1, 1}, {1, 2}, {2, 3}}));
+}
+
+struct no_default_mapped
+{
+    using serialize = zpp::bits::members<1>;
+
+    explicit no_default_mapped(int value) : value(value)
+    {
+    }
+
+    int value;
+
+    bool operator==(const no_default_mapped &) const = default;
+
+private:
+    friend zpp::bits::access;
+    no_default_mapped() = default;
+};
+
+TEST(map, mapped_not_default_constructible)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::map<int, no_default_mapped>{{1, no_default_mapped{2}}})
+        .or_throw();
+
+    std::map<int, no_default_mapped> s;
+    in(s).or_throw();
+
+    EXPECT_EQ(s, (std::map<int, no_default_mapped>{{1, no_default_mapped{2}}}));
+}
+
+TEST(map, failed_mapped_value_is_not_inserted)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::map<int, std::string>{{1, "a"}, {2, "long enough value"}})
+        .or_throw();
+    data.resize(data.size() - 1);
+
+    zpp::bits::in in(data);
+    std::map<int, std::string> s;
+    EXPECT_EQ(in(s), std::errc::result_out_of_range);
+    EXPECT_EQ(s, (std::map<int, std::string>{{1, "a"}}));
+
+    zpp::bits::in unordered_in(data);
+    std::unordered_map<int, std::string> u;
+    EXPECT_EQ(unordered_in(u), std::errc::result_out_of_range);
+    EXPECT_EQ(u, (std::unordered_map<int, std::string>{{1, "a"}}));
+}
@@ -0,0 +1,111 @@
+#include "test.h"
+#include <cstdio>
+
+namespace test_mapped_file
+{
+
+struct record
+{
+    std::uint64_t id;
+    std::string_view name;
+    std::span<const std::byte> payload;
+    std::vector<int> values;
+};
+
+struct temporary_file
+{
+    explicit temporary_file(std::span<const std::byte> data) :
+        file(std::tmpfile())
+    {
+        if (!data.empty()) {
+            std::fwrite(data.data(), 1, data.size(), file);
+        }
+        std::fflush(file);
+    }
+
+    ~temporary_file()
+    {
+        std::fclose(file);
+    }
+
+    int fd() const
+    {
+        return fileno(file);
+    }
+
+    std::FILE * file;
+};
+
+std::vector<std::byte> make_data()
+{
+    std::array<std::byte, 3> payload{
+        std::byte{1}, std::byte{2}, std::byte{3}};
+    auto [data, out] = zpp::bits::data_out();
+    out(record{1, "first", payload, {1, 2}},
+        record{2, "second", std::span{payload}.first(1), {3}})
+        .or_throw();
+    return data;
+}
+
+TEST(mapped_file, aliases_mapping)
+{
+    temporary_file file(make_data());
+    auto mapping = zpp::bits::mapped_file::map(file.fd()).or_throw();
+    ASSERT_EQ(mapping.size(), make_data().size());
+
+    zpp::bits::in in(mapping);
+    record first, second;
+    in(first, second).or_throw();
+    EXPECT_EQ(in.position(), mapping.size());
+
+    EXPECT_EQ(first.id, 1u);
+    EXPECT_EQ(first.name, "first");
+    EXPECT_EQ(first.values, (std::vector<int>{1, 2}));
+    ASSERT_EQ(first.payload.size(), 3u);
+    EXPECT_EQ(first.payload[2], std::byte{3});
+    EXPECT_EQ(second.name, "second");
+    EXPECT_EQ(second.payload.size(), 1u);
+
+    auto inside = [&](const void * pointer) {
+        auto byte = static_cast<const std::byte *>(pointer);
+        return mapping.begin() <= byte && byte < mapping.end();
+    };
+    EXPECT_TRUE(inside(first.name.data()));
+    EXPECT_TRUE(inside(first.payload.data()));
+    EXPECT_TRUE(inside(second.name.data()));
+}
+
+TEST(mapped_file, decode_mapped_keeps_mapping_alive)
+{
+    temporary_file file(make_data());
+    std::shared_ptr<record> value;
+    {
+        auto mapping = zpp::bits::mapped_file::map(file.fd()).or_throw();
+        value = zpp::bits::decode_mapped<record>(std::move(mapping))
+                    .or_throw();
+        EXPECT_EQ(mapping.data(), nullptr);
+    }
+    EXPECT_EQ(value->id, 1u);
+    EXPECT_EQ(value->name, "first");
+    ASSERT_EQ(value->payload.size(), 3u);
+    EXPECT_EQ(value->payload[0], std::byte{1});
+}
+
+TEST(mapped_file, errors)
+{
+    auto missing = zpp::bits::mapped_file::open("/nonexistent/zpp_bits");
+    ASSERT_TRUE(missing.failure());
+    EXPECT_EQ(missing.error(), std::errc::no_such_file_or_directory);
+
+    auto decoded =
+        zpp::bits::decode_mapped<record>("/nonexistent/zpp_bits");
+    EXPECT_EQ(decoded.error(), std::errc::no_such_file_or_directory);
+
+    temporary_file empty({});
+    auto mapping = zpp::bits::mapped_file::map(empty.fd()).or_throw();
+    EXPECT_EQ(mapping.size(), 0u);
+    EXPECT_EQ(zpp::bits::decode_mapped<record>(std::move(mapping)).error(),
+              std::errc::result_out_of_range);
+}
+
+} // namespace test_mapped_file
@@ -0,0 +1,108 @@
+#include "test.h"
+#include <bitset>
+
+namespace test_max_size
+{
+
+static_assert(zpp::bits::max_size_v<int> == sizeof(int));
+static_assert(zpp::bits::max_size_v<std::byte> == 1);
+static_assert(zpp::bits::max_size_v<zpp::bits::vint32_t> == 5);
+static_assert(zpp::bits::max_size_v<zpp::bits::vsint64_t> == 10);
+static_assert(zpp::bits::max_size_v<std::bitset<17>> == 3);
+static_assert(zpp::bits::max_size_v<std::array<std::uint16_t, 5>> == 10);
+static_assert(zpp::bits::max_size_v<std::span<int, 3>> == 12);
+static_assert(zpp::bits::max_size_v<int[4]> == 16);
+static_assert(zpp::bits::max_size_v<std::optional<std::int64_t>> == 9);
+static_assert(zpp::bits::max_size_v<std::variant<char, std::int64_t>> == 9);
+static_assert(zpp::bits::max_size_v<std::tuple<char, int>> == 5);
+static_assert(zpp::bits::max_size_v<std::pair<char, zpp::bits::vuint64_t>> ==
+              11);
+static_assert(zpp::bits::max_size_v<std::monostate> == 0);
+
+static_assert(zpp::bits::max_size_v<std::string> == zpp::bits::unbounded_size);
+static_assert(zpp::bits::max_size_v<std::vector<int>> ==
+              zpp::bits::unbounded_size);
+static_assert(zpp::bits::max_size_v<std::span<int>> ==
+              zpp::bits::unbounded_size);
+static_assert(zpp::bits::max_size_v<std::unique_ptr<int>> ==
+              zpp::bits::unbounded_size);
+static_assert(zpp::bits::max_size_v<std::variant<int, std::string>> ==
+              zpp::bits::unbounded_size);
+static_assert(zpp::bits::max_size_v<std::array<std::string, 2>> ==
+              zpp::bits::unbounded_size);
+
+struct point
+{
+    char kind;
+    std::optional<zpp::bits::vint64_t> x;
+    std::array<std::variant<std::byte, double>, 2> y;
+    std::bitset<9> flags;
+};
+
+static_assert(zpp::bits::max_size_v<point> == 1 + 11 + 18 + 2);
+
+struct padded
+{
+    char c;
+    int i;
+};
+
+static_assert(zpp::bits::max_size_v<padded> == 5);
+
+struct named
+{
+    int id;
+    std::string name;
+};
+
+static_assert(zpp::bits::max_size_v<named> == zpp::bits::unbounded_size);
+
+struct custom
+{
+    int i;
+
+    constexpr static auto serialize(auto & archive, auto & self)
+    {
+        return archive(self.i);
+    }
+};
+
+static_assert(zpp::bits::max_size_v<custom> == zpp::bits::unbounded_size);
+
+struct pb_message
+{
+    zpp::bits::vint32_t i;
+};
+
+auto serialize(const pb_message &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+static_assert(zpp::bits::max_size_v<pb_message> ==
+              zpp::bits::unbounded_size);
+
+TEST(max_size, serialize_into_array)
+{
+    point value{'p', zpp::bits::vint64_t{-1}, {{double{1}, double{2}}}, {}};
+    value.flags.set();
+
+    std::array<std::byte, zpp::bits::max_size_v<point>> data;
+    zpp::bits::out out(data);
+    out(value).or_throw();
+    EXPECT_EQ(out.position(), data.size());
+
+    point decoded{};
+    zpp::bits::in in(data);
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.x, value.x);
+    EXPECT_EQ(decoded.y, value.y);
+    EXPECT_EQ(decoded.flags, value.flags);
+}
+
+TEST(max_size, bounds_sizer)
+{
+    std::tuple<zpp::bits::vuint32_t, std::optional<int>> value{
+        0xffffffff, 5};
+    EXPECT_LE(zpp::bits::size_of(value).or_throw(),
+              (zpp::bits::max_size_v<decltype(value)>));
+}
+
+} // namespace test_max_size
@@ -0,0 +1,155 @@
+#include "test.h"
+
+namespace test_member_runs
+{
+
+using archive = zpp::bits::out<std::vector<std::byte>>;
+
+static_assert(zpp::bits::traits::member_runs<archive,
+                                             int,
+                                             int,
+                                             std::string,
+                                             char,
+                                             char,
+                                             short,
+                                             int>() ==
+              std::array<std::size_t, 7>{2, 0, 1, 4, 0, 0, 0});
+static_assert(zpp::bits::traits::member_runs<archive, char, int, char>() ==
+              std::array<std::size_t, 3>{1, 2, 0});
+static_assert(
+    zpp::bits::traits::member_runs<archive, int, std::monostate, int>() ==
+    std::array<std::size_t, 3>{1, 1, 1});
+static_assert(!zpp::bits::traits::has_member_runs<
+              zpp::bits::out<std::vector<std::byte>, zpp::bits::endian::swapped>,
+              int,
+              int>());
+
+struct position
+{
+    int x;
+    int y;
+};
+
+struct entity
+{
+    std::uint64_t id;
+    position where;
+    std::uint32_t flags;
+    std::string name;
+    char kind;
+    bool alive;
+    std::uint16_t level;
+    std::int32_t health;
+    std::vector<int> items;
+    double weight;
+};
+
+entity make_entity()
+{
+    return {0x1122334455667788,
+            {-1, 2},
+            0xaabbccdd,
+            "entity",
+            'e',
+            true,
+            0x1234,
+            -100,
+            {1, 2, 3},
+            2.5};
+}
+
+TEST(member_runs, matches_members)
+{
+    auto value = make_entity();
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(value.id,
+                 value.where.x,
+                 value.where.y,
+                 value.flags,
+                 value.name,
+                 value.kind,
+                 value.alive,
+                 value.level,
+                 value.health,
+                 value.items,
+                 value.weight)
+        .or_throw();
+
+    EXPECT_EQ(encode_hex(data), encode_hex(expected));
+    EXPECT_EQ(zpp::bits::size_of(value).or_throw(), data.size());
+}
+
+TEST(member_runs, round_trip)
+{
+    auto value = make_entity();
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(value).or_throw();
+
+    entity decoded{};
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.id, value.id);
+    EXPECT_EQ(decoded.where.x, value.where.x);
+    EXPECT_EQ(decoded.where.y, value.where.y);
+    EXPECT_EQ(decoded.flags, value.flags);
+    EXPECT_EQ(decoded.name, value.name);
+    EXPECT_EQ(decoded.kind, value.kind);
+    EXPECT_EQ(decoded.alive, value.alive);
+    EXPECT_EQ(decoded.level, value.level);
+    EXPECT_EQ(decoded.health, value.health);
+    EXPECT_EQ(decoded.items, value.items);
+    EXPECT_EQ(decoded.weight, value.weight);
+    EXPECT_EQ(in.position(), data.size());
+}
+
+TEST(member_runs, endian_swapped)
+{
+    auto value = make_entity();
+    auto [data, in, out] =
+        zpp::bits::data_in_out(zpp::bits::endian::swapped{});
+    out(value).or_throw();
+    EXPECT_EQ(encode_hex(data).substr(0, 24), "1122334455667788ffffffff");
+
+    entity decoded{};
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.id, value.id);
+    EXPECT_EQ(decoded.level, value.level);
+    EXPECT_EQ(decoded.weight, value.weight);
+}
+
+TEST(member_runs, truncated)
+{
+    auto value = make_entity();
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+    data.resize(data.size() - 1);
+
+    zpp::bits::in in(data);
+    entity decoded{};
+    EXPECT_EQ(in(decoded), std::errc::result_out_of_range);
+}
+
+struct constexpr_entity
+{
+    int a;
+    int b;
+    std::array<char, 3> c;
+};
+
+constexpr auto constexpr_round_trip()
+{
+    std::array<std::byte, 11> data{};
+    zpp::bits::out out(data);
+    out(constexpr_entity{1, 2, {'a', 'b', 'c'}}).or_throw();
+
+    constexpr_entity value{};
+    zpp::bits::in in(data);
+    in(value).or_throw();
+    return value.a + value.b + value.c[2];
+}
+
+static_assert(constexpr_round_trip() == 3 + 'c');
+
+} // namespace test_member_runs
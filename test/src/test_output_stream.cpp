@@ -0,0 +1,294 @@
+#include "test.h"
+#include <cstdio>
+#include <sstream>
+
+namespace test_output_stream
+{
+
+struct collector
+{
+    std::vector<std::byte> data;
+    std::vector<std::size_t> writes;
+
+    void operator()(std::span<const std::byte> bytes)
+    {
+        data.insert(data.end(), bytes.begin(), bytes.end());
+        writes.push_back(bytes.size());
+    }
+};
+
+struct person
+{
+    std::string name;
+    std::uint64_t id;
+    std::vector<std::uint32_t> numbers;
+    std::optional<std::map<int, std::string>> extra;
+};
+
+person make_person()
+{
+    person value{"a long enough name", 0x1122334455667788, {}, {}};
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        value.numbers.push_back(i);
+    }
+    value.extra = std::map<int, std::string>{{1, "one"}, {2, "two"}};
+    return value;
+}
+
+TEST(output_stream, matches_vector)
+{
+    auto value = make_person();
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(value, std::variant<int, char>{'c'}).or_throw();
+
+    collector sink;
+    {
+        zpp::bits::output_stream stream(sink, 16);
+        zpp::bits::out out(stream);
+        out(value, std::variant<int, char>{'c'}).or_throw();
+        EXPECT_EQ(stream.total_size(), expected.size());
+    }
+
+    EXPECT_EQ(sink.data, expected);
+    for (auto size : sink.writes) {
+        EXPECT_LE(size, 400u + 16u);
+    }
+}
+
+TEST(output_stream, large_bytes_bypass_staging)
+{
+    std::vector<char> payload(1000, 'x');
+    collector sink;
+    zpp::bits::output_stream stream(sink, 64);
+    zpp::bits::out out(stream);
+    out(std::uint32_t{1}, payload, std::uint8_t{2}).or_throw();
+    stream.flush().or_throw();
+
+    EXPECT_EQ(sink.writes, (std::vector<std::size_t>{8, 1000, 1}));
+    EXPECT_EQ(sink.data.size(), 4u + 4u + 1000u + 1u);
+}
+
+TEST(output_stream, appends_across_archives)
+{
+    collector sink;
+    zpp::bits::output_stream stream(sink, 16);
+    for (int i = 0; i < 10; ++i) {
+        zpp::bits::out out(stream);
+        out(i).or_throw();
+    }
+    stream.flush().or_throw();
+
+    zpp::bits::in in(sink.data);
+    for (int i = 0; i < 10; ++i) {
+        int value{};
+        in(value).or_throw();
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(in.remaining_data().size(), 0u);
+}
+
+struct padded
+{
+    char c;
+    int i;
+};
+
+TEST(output_stream, grows_for_fixed_size_items)
+{
+    std::array<padded, 10> value{};
+    collector sink;
+    zpp::bits::output_stream stream(sink, 8);
+    zpp::bits::out out(stream);
+    out(std::byte{1}, value).or_throw();
+    stream.flush().or_throw();
+
+    EXPECT_EQ(sink.data.size(), 1u + 50u);
+}
+
+TEST(output_stream, errors)
+{
+    auto sink = [](std::span<const std::byte>) -> zpp::bits::errc {
+        return std::errc::io_error;
+    };
+    zpp::bits::output_stream stream(sink, 16);
+    zpp::bits::out out(stream);
+    EXPECT_EQ(out(std::array<std::uint64_t, 4>{}), std::errc::io_error);
+}
+
+TEST(output_stream, alloc_limit)
+{
+    collector sink;
+    zpp::bits::output_stream stream(sink, 16);
+    zpp::bits::out out(stream, zpp::bits::alloc_limit<32>{});
+    EXPECT_EQ(out(std::array<std::uint64_t, 5>{}),
+              std::errc::no_buffer_space);
+    EXPECT_EQ(out(std::vector<char>(40)), std::errc::no_buffer_space);
+}
+
+TEST(output_stream, ostream)
+{
+    std::ostringstream stream_data;
+    {
+        zpp::bits::output_stream stream(stream_data, 16);
+        zpp::bits::out out(stream);
+        out(make_person()).or_throw();
+    }
+
+    auto [expected, out_expected] = zpp::bits::data_out<char>();
+    out_expected(make_person()).or_throw();
+    EXPECT_EQ(stream_data.str(),
+              std::string(expected.begin(), expected.end()));
+}
+
+TEST(output_stream, file)
+{
+    auto file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        zpp::bits::output_stream stream(file, 16);
+        zpp::bits::out out(stream);
+        out(make_person()).or_throw();
+    }
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(make_person()).or_throw();
+
+    std::vector<std::byte> data(expected.size() + 1);
+    std::rewind(file);
+    EXPECT_EQ(std::fread(data.data(), 1, data.size(), file), expected.size());
+    data.resize(expected.size());
+    EXPECT_EQ(data, expected);
+    std::fclose(file);
+}
+
+TEST(output_stream, file_descriptor)
+{
+    auto file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        zpp::bits::output_stream stream(fileno(file), 16);
+        zpp::bits::out out(stream);
+        out(make_person()).or_throw();
+    }
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(make_person()).or_throw();
+
+    std::vector<std::byte> data(expected.size());
+    std::rewind(file);
+    EXPECT_EQ(std::fread(data.data(), 1, data.size(), file), expected.size());
+    EXPECT_EQ(data, expected);
+    std::fclose(file);
+}
+
+struct pb_inner
+{
+    std::string text;
+};
+
+auto serialize(const pb_inner &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+struct pb_outer
+{
+    zpp::bits::vint32_t id;
+    pb_inner inner;
+    std::string text;
+    std::vector<pb_inner> inners;
+};
+
+auto serialize(const pb_outer &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+class output_stream_sized : public ::testing::TestWithParam<std::size_t>
+{
+};
+
+TEST_P(output_stream_sized, pb_matches_vector)
+{
+    pb_outer value{1337,
+                   {std::string(300, 'i')},
+                   std::string(200, 'o'),
+                   {{"a"}, {std::string(150, 'b')}}};
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(value).or_throw();
+
+    collector sink;
+    zpp::bits::output_stream stream(sink, GetParam());
+    zpp::bits::out out(stream);
+    out(value).or_throw();
+    stream.flush().or_throw();
+
+    EXPECT_EQ(encode_hex(sink.data), encode_hex(expected));
+
+    auto [expected_varint, out_varint] =
+        zpp::bits::data_out(zpp::bits::size_varint{});
+    out_varint(value, value).or_throw();
+
+    collector sink_varint;
+    zpp::bits::output_stream stream_varint(sink_varint, GetParam());
+    zpp::bits::out out_stream_varint(stream_varint, zpp::bits::size_varint{});
+    out_stream_varint(value, value).or_throw();
+    stream_varint.flush().or_throw();
+
+    EXPECT_EQ(encode_hex(sink_varint.data), encode_hex(expected_varint));
+}
+
+struct counting_protocol
+{
+    static inline int measured = 0;
+
+    constexpr auto operator()(auto & archive, auto & item) const
+    {
+        if constexpr (std::remove_cvref_t<decltype(archive)>::measuring) {
+            ++measured;
+        }
+        return archive(item.value, item.children);
+    }
+};
+
+struct node
+{
+    using serialize = zpp::bits::protocol<counting_protocol{}>;
+
+    int value{};
+    std::vector<node> children;
+};
+
+// An option that is not default constructible.
+struct tagged : zpp::bits::option<tagged>
+{
+    explicit tagged(int value) : value(value)
+    {
+    }
+    int value;
+};
+
+TEST(output_stream, nested_sizes_measured_once)
+{
+    node root{0, {}};
+    auto * level = &root;
+    for (int depth = 1; depth < 10; ++depth) {
+        level->children = {node{depth, {}}, node{-depth, {}}};
+        level = &level->children.front();
+    }
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(root, root).or_throw();
+
+    collector sink;
+    zpp::bits::output_stream stream(sink, 16);
+    zpp::bits::out out(stream, tagged{1});
+    counting_protocol::measured = 0;
+    out(root, root).or_throw();
+    stream.flush().or_throw();
+
+    EXPECT_EQ(encode_hex(sink.data), encode_hex(expected));
+    // Every node of both roots is measured once.
+    EXPECT_EQ(counting_protocol::measured, 2 * 19);
+}
+
+INSTANTIATE_TEST_SUITE_P(output_stream,
+                         output_stream_sized,
+                         ::testing::Values(16, 64, 256, 0x10000));
+
+} // namespace test_output_stream
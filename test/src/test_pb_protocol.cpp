@@ -116,6 +116,77 @@ TEST(test_pb_protocol, test_repeated_integers)
         (std::vector<zpp::bits::vsint32_t>{1, 2, 3, 4, -1, -2, -3, -4}));
 }
 
+TEST(test_pb_protocol, test_repeated_integers_bulk)
+{
+    repeated_integers integers;
+    for (int i = 0; i < 1000; ++i) {
+        integers.integers.push_back(i % 7 ? i % 50 : i * -99991);
+    }
+
+    auto [data, in, out] = zpp::bits::data_in_out(zpp::bits::no_size{});
+    out(integers).or_throw();
+
+    std::size_t size = 0;
+    for (auto value : integers.integers) {
+        size += zpp::bits::varint_size<zpp::bits::varint_encoding::zig_zag>(
+            value.value);
+    }
+    auto [expected, expected_out] = zpp::bits::data_out();
+    expected_out(std::byte{0x0a}, zpp::bits::vsize_t{size}).or_throw();
+    for (auto value : integers.integers) {
+        expected_out(value).or_throw();
+    }
+    EXPECT_EQ(data, expected);
+
+    repeated_integers r;
+    in(r).or_throw();
+    EXPECT_EQ(r.integers, integers.integers);
+}
+
+TEST(test_pb_protocol, test_repeated_integers_split)
+{
+    auto data = "0a0202040a0106"_decode_hex;
+
+    repeated_integers r;
+    zpp::bits::in{data, zpp::bits::no_size{}}(r).or_throw();
+    EXPECT_EQ(r.integers, (std::vector<zpp::bits::vsint32_t>{1, 2, 3}));
+}
+
+TEST(test_pb_protocol, test_repeated_integers_truncated)
+{
+    auto data = "0a020284"_decode_hex;
+
+    repeated_integers r;
+    EXPECT_EQ(zpp::bits::in(data, zpp::bits::no_size{})(r),
+              std::errc::result_out_of_range);
+}
+
+enum class shade
+{
+    light = 1,
+    dark = 300,
+};
+
+struct repeated_shades
+{
+    using serialize = zpp::bits::protocol<zpp::bits::pb{}>;
+    std::vector<shade> shades;
+};
+
+TEST(test_pb_protocol, test_repeated_enums)
+{
+    auto [data, in, out] = zpp::bits::data_in_out(zpp::bits::no_size{});
+    out(repeated_shades{
+            .shades = {shade::light, shade::dark, shade::light}})
+        .or_throw();
+    EXPECT_EQ(encode_hex(data), "0a0401ac0201");
+
+    repeated_shades r;
+    in(r).or_throw();
+    EXPECT_EQ(r.shades,
+              (std::vector<shade>{shade::light, shade::dark, shade::light}));
+}
+
 struct repeated_examples
 {
     using serialize = zpp::bits::protocol<zpp::bits::pb{}>;
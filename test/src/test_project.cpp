@@ -0,0 +1,139 @@
+#include "test.h"
+
+namespace test_project
+{
+
+struct record
+{
+    std::uint64_t id;
+    std::string name;
+    std::vector<std::string> tags;
+    double score;
+    std::optional<std::map<int, std::string>> extra;
+    std::string comment;
+};
+
+record make_record()
+{
+    return {7, "name", {"a", "b"}, 1.5, std::map<int, std::string>{{1, "x"}},
+            "comment"};
+}
+
+static_assert(zpp::bits::traits::member_mask<record,
+                                             &record::comment,
+                                             &record::name>() ==
+              std::array{false, true, false, false, false, true});
+
+TEST(project, decodes_selected_members)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_record(), std::uint32_t{0x11223344}).or_throw();
+
+    zpp::bits::in in(data);
+    record value{};
+    in.project<&record::name, &record::score>(value).or_throw();
+    std::uint32_t last{};
+    in(last).or_throw();
+    EXPECT_EQ(last, 0x11223344u);
+
+    EXPECT_EQ(value.id, 0u);
+    EXPECT_EQ(value.name, "name");
+    EXPECT_TRUE(value.tags.empty());
+    EXPECT_EQ(value.score, 1.5);
+    EXPECT_FALSE(value.extra);
+    EXPECT_TRUE(value.comment.empty());
+}
+
+TEST(project, all_and_none)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_record()).or_throw();
+
+    zpp::bits::in in(data);
+    record value{};
+    in.project<&record::id,
+               &record::name,
+               &record::tags,
+               &record::score,
+               &record::extra,
+               &record::comment>(value)
+        .or_throw();
+    EXPECT_EQ(value.tags, make_record().tags);
+    EXPECT_EQ(value.extra, make_record().extra);
+    EXPECT_EQ(value.comment, "comment");
+    EXPECT_EQ(in.position(), data.size());
+
+    zpp::bits::in none_in(data);
+    record none{};
+    none_in.project<>(none).or_throw();
+    EXPECT_EQ(none_in.position(), data.size());
+    EXPECT_TRUE(none.name.empty());
+}
+
+struct grouped
+{
+    std::vector<
+        zpp::bits::varint<std::uint32_t, zpp::bits::varint_encoding::group>>
+        values;
+    std::uint32_t tail;
+};
+
+TEST(project, group_varints)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(grouped{{1, 300, 70000, 4, 5}, 9}, std::uint32_t{0x11223344})
+        .or_throw();
+
+    zpp::bits::in in(data);
+    grouped value{};
+    in.project<&grouped::tail>(value).or_throw();
+    std::uint32_t last{};
+    in(last).or_throw();
+    EXPECT_EQ(value.tail, 9u);
+    EXPECT_TRUE(value.values.empty());
+    EXPECT_EQ(last, 0x11223344u);
+}
+
+TEST(project, truncated)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_record()).or_throw();
+    data.resize(data.size() - 1);
+
+    zpp::bits::in in(data);
+    record value{};
+    EXPECT_EQ(in.project<&record::name>(value),
+              std::errc::result_out_of_range);
+    EXPECT_EQ(value.name, "name");
+}
+
+TEST(project, streaming_commits)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_record(), std::uint8_t{7}).or_throw();
+
+    std::span<const std::byte> remaining = data;
+    zpp::bits::input_stream stream(
+        [&](std::span<std::byte> bytes) {
+            auto count = std::min(bytes.size(), remaining.size());
+            std::copy_n(remaining.begin(), count, bytes.begin());
+            remaining = remaining.subspan(count);
+            return count;
+        },
+        256);
+    record value{};
+    {
+        zpp::bits::in in(stream);
+        in.project<&record::tags>(value).or_throw();
+    }
+    EXPECT_EQ(value.tags, make_record().tags);
+
+    // A new archive continues after the projected record.
+    zpp::bits::in in(stream);
+    std::uint8_t last{};
+    in(last).or_throw();
+    EXPECT_EQ(last, 7);
+    EXPECT_TRUE(stream.exhausted());
+}
+
+} // namespace test_project
@@ -0,0 +1,224 @@
+#include "test.h"
+
+namespace test_resumable_in
+{
+
+struct item
+{
+    std::string name;
+    std::vector<int> values;
+};
+
+struct message
+{
+    std::uint32_t id;
+    std::vector<item> items;
+    std::optional<std::string> note;
+    zpp::bits::vint64_t tail;
+};
+
+message make_message()
+{
+    message value{7, {}, "note", -3};
+    for (int i = 0; i < 20; ++i) {
+        value.items.push_back({std::to_string(i), {i, i + 1}});
+    }
+    return value;
+}
+
+void expect_message(const message & decoded)
+{
+    auto value = make_message();
+    EXPECT_EQ(decoded.id, value.id);
+    ASSERT_EQ(decoded.items.size(), value.items.size());
+    for (std::size_t i = 0; i < value.items.size(); ++i) {
+        EXPECT_EQ(decoded.items[i].name, value.items[i].name);
+        EXPECT_EQ(decoded.items[i].values, value.items[i].values);
+    }
+    EXPECT_EQ(decoded.note, value.note);
+    EXPECT_EQ(decoded.tail, value.tail);
+}
+
+class resumable_in_chunked : public ::testing::TestWithParam<std::size_t>
+{
+};
+
+TEST_P(resumable_in_chunked, matches_in)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_message()).or_throw();
+
+    zpp::bits::resumable_in<message> decoder;
+    std::span<const std::byte> input = data;
+    while (!decoder.done()) {
+        ASSERT_FALSE(input.empty());
+        auto count = std::min(GetParam(), input.size());
+        decoder.append(input.first(count));
+        input = input.subspan(count);
+
+        auto result = decoder.resume();
+        if (decoder.done()) {
+            EXPECT_EQ(result, std::errc{});
+        } else {
+            EXPECT_EQ(result, std::errc::result_out_of_range);
+            EXPECT_GE(decoder.needed(), 1u);
+            EXPECT_LE(decoder.needed(), input.size());
+        }
+    }
+    EXPECT_TRUE(input.empty());
+    EXPECT_TRUE(decoder.remaining_data().empty());
+    expect_message(decoder.value());
+}
+
+INSTANTIATE_TEST_SUITE_P(resumable_in,
+                         resumable_in_chunked,
+                         ::testing::Values(1, 3, 16, 1000));
+
+TEST(resumable_in, reports_needed_bytes)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::string>{std::string(100, 'a'), "b"}).or_throw();
+
+    zpp::bits::resumable_in<std::vector<std::string>> decoder;
+    decoder.append(std::span{data}.first(10));
+    EXPECT_EQ(decoder.resume(), std::errc::result_out_of_range);
+    // The vector size, then the size and 2 bytes of the first string.
+    EXPECT_EQ(decoder.needed(), 98u);
+
+    decoder.append(std::span{data}.subspan(10, 98));
+    EXPECT_EQ(decoder.resume(), std::errc::result_out_of_range);
+    EXPECT_EQ(decoder.needed(), 4u);
+
+    decoder.append(std::span{data}.subspan(108));
+    EXPECT_EQ(decoder.resume(), std::errc{});
+    EXPECT_EQ(decoder.needed(), 0u);
+    EXPECT_EQ(decoder.value(),
+              (std::vector<std::string>{std::string(100, 'a'), "b"}));
+}
+
+struct counted
+{
+    inline static int decodes = 0;
+
+    std::uint64_t value;
+
+    constexpr static auto serialize(auto & archive, auto & self)
+    {
+        if constexpr (std::remove_cvref_t<decltype(archive)>::kind() ==
+                      zpp::bits::kind::in) {
+            ++decodes;
+        }
+        return archive(self.value);
+    }
+};
+
+TEST(resumable_in, keeps_decoded_elements)
+{
+    std::vector<counted> value(100);
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+
+    counted::decodes = 0;
+    zpp::bits::resumable_in<std::vector<counted>> decoder;
+    std::size_t received = 0;
+    for (auto byte : data) {
+        decoder.append(std::span{&byte, 1});
+        if (++received >= decoder.needed()) {
+            static_cast<void>(decoder.resume());
+            received = 0;
+        }
+    }
+    EXPECT_TRUE(decoder.done());
+    EXPECT_EQ(decoder.value().size(), 100u);
+    // Each element is attempted with no bytes, then once complete.
+    EXPECT_EQ(counted::decodes, 100 * 2);
+}
+
+TEST(resumable_in, messages)
+{
+    auto [data, out] = zpp::bits::data_out(zpp::bits::size_varint{});
+    for (int i = 0; i < 10; ++i) {
+        out(std::to_string(i), zpp::bits::varint{i}).or_throw();
+    }
+
+    using pair = std::pair<std::string, zpp::bits::vint32_t>;
+    zpp::bits::resumable_in<pair, zpp::bits::size_varint> decoder;
+    std::span<const std::byte> input = data;
+    int count = 0;
+    while (!input.empty()) {
+        auto size = std::min<std::size_t>(input.size(), 5);
+        decoder.append(input.first(size));
+        input = input.subspan(size);
+        while (decoder.resume() == std::errc{}) {
+            EXPECT_EQ(decoder.value().first, std::to_string(count));
+            EXPECT_EQ(decoder.value().second, count);
+            ++count;
+            decoder.reset();
+        }
+    }
+    EXPECT_EQ(count, 10);
+}
+
+struct node
+{
+    int value;
+    std::vector<node> children;
+};
+
+TEST(resumable_in, recursive)
+{
+    node tree{1, {{2, {{3, {}}}}, {4, {}}}};
+    auto [data, out] = zpp::bits::data_out();
+    out(tree).or_throw();
+
+    zpp::bits::resumable_in<node> decoder;
+    for (auto byte : data) {
+        decoder.append(std::span{&byte, 1});
+        static_cast<void>(decoder.resume());
+    }
+    ASSERT_TRUE(decoder.done());
+    auto & decoded = decoder.value();
+    EXPECT_EQ(decoded.value, 1);
+    ASSERT_EQ(decoded.children.size(), 2u);
+    ASSERT_EQ(decoded.children[0].children.size(), 1u);
+    EXPECT_EQ(decoded.children[0].children[0].value, 3);
+    EXPECT_EQ(decoded.children[1].value, 4);
+}
+
+struct grouped
+{
+    std::vector<
+        zpp::bits::varint<std::uint32_t, zpp::bits::varint_encoding::group>>
+        values;
+    std::uint32_t tail;
+};
+
+TEST(resumable_in, group_varints)
+{
+    grouped value{{1, 300, 70000, 4, 5}, 9};
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+
+    zpp::bits::resumable_in<grouped> decoder;
+    for (auto byte : data) {
+        decoder.append(std::span{&byte, 1});
+        static_cast<void>(decoder.resume());
+    }
+    ASSERT_TRUE(decoder.done());
+    EXPECT_EQ(decoder.value().values, value.values);
+    EXPECT_EQ(decoder.value().tail, 9u);
+}
+
+TEST(resumable_in, errors)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::vector<int>>{{1, 2, 3}}).or_throw();
+
+    zpp::bits::resumable_in<std::vector<std::vector<int>>,
+                            zpp::bits::alloc_limit<8>>
+        decoder;
+    decoder.append(std::span{data});
+    EXPECT_EQ(decoder.resume(), std::errc::message_size);
+}
+
+} // namespace test_resumable_in
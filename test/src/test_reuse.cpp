@@ -0,0 +1,187 @@
+#include "test.h"
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace test_reuse
+{
+
+inline std::size_t allocations = 0;
+
+template <typename Type>
+struct counting_allocator
+{
+    using value_type = Type;
+
+    counting_allocator() = default;
+
+    template <typename Other>
+    counting_allocator(const counting_allocator<Other> &)
+    {
+    }
+
+    Type * allocate(std::size_t count)
+    {
+        ++allocations;
+        return std::allocator<Type>{}.allocate(count);
+    }
+
+    void deallocate(Type * pointer, std::size_t count)
+    {
+        std::allocator<Type>{}.deallocate(pointer, count);
+    }
+
+    friend bool operator==(const counting_allocator &,
+                           const counting_allocator &) = default;
+};
+
+using string =
+    std::basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+
+struct no_default
+{
+    using serialize = zpp::bits::members<1>;
+
+    explicit no_default(int) {}
+
+    string text;
+
+private:
+    friend zpp::bits::access;
+    no_default() = default;
+};
+
+struct message
+{
+    std::unique_ptr<std::vector<int>> values;
+    std::optional<no_default> extra;
+    std::optional<string> note;
+    std::map<int,
+             string,
+             std::less<>,
+             counting_allocator<std::pair<const int, string>>>
+        names;
+    std::set<int, std::less<>, counting_allocator<int>> ids;
+};
+
+message make_message(int seed)
+{
+    message result{std::make_unique<std::vector<int>>(
+                       std::vector<int>{seed, seed + 1, seed + 2}),
+                   no_default{0},
+                   {},
+                   {},
+                   {}};
+    result.extra->text = "some text longer than the small buffer " +
+                         string(1, char('a' + seed));
+    result.note = "a note longer than the small buffer " +
+                  string(1, char('a' + seed));
+    for (int i = 0; i < 8; ++i) {
+        result.names.emplace(seed * 10 + i,
+                             "a name longer than the small buffer " +
+                                 string(1, char('a' + i)));
+        result.ids.insert(seed * 10 + i);
+    }
+    return result;
+}
+
+TEST(reuse, steady_state_does_not_allocate)
+{
+    std::vector<std::vector<std::byte>> messages;
+    std::vector<message> expected;
+    for (int seed = 0; seed < 3; ++seed) {
+        auto [data, out] = zpp::bits::data_out();
+        expected.push_back(make_message(seed));
+        out(expected.back()).or_throw();
+        messages.push_back(data);
+    }
+
+    message decoded{};
+    zpp::bits::in{messages[0], zpp::bits::reuse{}}(decoded).or_throw();
+    auto values = decoded.values.get();
+
+    allocations = 0;
+    for (int seed = 1; seed < 3; ++seed) {
+        zpp::bits::in in{messages[seed], zpp::bits::reuse{}};
+        in(decoded).or_throw();
+
+        EXPECT_EQ(*decoded.values, *expected[seed].values);
+        EXPECT_EQ(decoded.extra->text, expected[seed].extra->text);
+        EXPECT_EQ(decoded.note, expected[seed].note);
+        EXPECT_EQ(decoded.names, expected[seed].names);
+        EXPECT_EQ(decoded.ids, expected[seed].ids);
+    }
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(decoded.values.get(), values);
+}
+
+TEST(reuse, without_reuse_allocates)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(make_message(1)).or_throw();
+
+    message decoded = make_message(0);
+    auto values = decoded.values.get();
+
+    allocations = 0;
+    in(decoded).or_throw();
+    EXPECT_NE(allocations, 0u);
+    EXPECT_NE(decoded.values.get(), values);
+    EXPECT_EQ(decoded.names, make_message(1).names);
+}
+
+TEST(reuse, grows_and_shrinks)
+{
+    using map = std::map<int, std::string>;
+    auto [data, out] = zpp::bits::data_out();
+    out(map{{1, "a"}, {2, "b"}, {3, "c"}}, map{{4, "d"}}, map{{5, "e"}, {6, "f"}})
+        .or_throw();
+
+    zpp::bits::in in{data, zpp::bits::reuse{}};
+    map decoded{{7, "g"}, {8, "h"}};
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded, (map{{1, "a"}, {2, "b"}, {3, "c"}}));
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded, (map{{4, "d"}}));
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded, (map{{5, "e"}, {6, "f"}}));
+}
+
+TEST(reuse, unordered_map_keeps_nodes)
+{
+    using map = std::unordered_map<int, std::string>;
+    auto [data, out] = zpp::bits::data_out();
+    out(map{{1, "a"}, {2, "b"}}).or_throw();
+
+    map decoded{{3, "c"}, {4, "d"}};
+    std::set<const void *> nodes;
+    for (auto & [key, value] : decoded) {
+        nodes.insert(std::addressof(value));
+    }
+
+    zpp::bits::in{data, zpp::bits::reuse{}}(decoded).or_throw();
+    EXPECT_EQ(decoded, (map{{1, "a"}, {2, "b"}}));
+    for (auto & [key, value] : decoded) {
+        EXPECT_TRUE(nodes.contains(std::addressof(value)));
+    }
+}
+
+TEST(reuse, shared_pointee_is_not_reused)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::make_shared<int>(2)).or_throw();
+
+    auto decoded = std::make_shared<int>(1);
+    auto shared = decoded;
+    zpp::bits::in{data, zpp::bits::reuse{}}(decoded).or_throw();
+    EXPECT_EQ(*decoded, 2);
+    EXPECT_EQ(*shared, 1);
+
+    shared.reset();
+    auto pointee = decoded.get();
+    zpp::bits::in{data, zpp::bits::reuse{}}(decoded).or_throw();
+    EXPECT_EQ(decoded.get(), pointee);
+}
+
+} // namespace test_reuse
@@ -0,0 +1,201 @@
+#include "test.h"
+
+namespace test_segmented_buffer
+{
+
+template <typename ByteType>
+std::vector<std::byte> flatten(const zpp::bits::segmented_buffer<ByteType> & data)
+{
+    std::vector<std::byte> result;
+    for (auto segment : data.segments()) {
+        auto bytes = std::as_bytes(segment);
+        result.insert(result.end(), bytes.begin(), bytes.end());
+    }
+    return result;
+}
+
+struct person
+{
+    std::string name;
+    std::uint64_t id;
+    std::vector<std::uint32_t> numbers;
+};
+
+TEST(segmented_buffer, matches_vector)
+{
+    person value{"a long enough name", 0x1122334455667788, {}};
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        value.numbers.push_back(i);
+    }
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(value, std::optional<int>{5}, std::variant<int, char>{'c'})
+        .or_throw();
+
+    zpp::bits::chunk_pool pool(7);
+    zpp::bits::segmented_buffer data(pool);
+    zpp::bits::out out(data);
+    out(value, std::optional<int>{5}, std::variant<int, char>{'c'})
+        .or_throw();
+
+    EXPECT_GT(data.segments().size(), 1u);
+    EXPECT_EQ(data.total_size(), expected.size());
+    EXPECT_EQ(flatten(data), expected);
+}
+
+TEST(segmented_buffer, bytes_split_across_chunks)
+{
+    std::vector<char> payload(1000);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = char(i);
+    }
+
+    zpp::bits::chunk_pool pool(64);
+    zpp::bits::segmented_buffer data(pool);
+    zpp::bits::out out(data, zpp::bits::no_size{});
+    out(std::uint8_t{1}, payload).or_throw();
+
+    EXPECT_EQ(data.segments().size(), 16u);
+    for (auto segment : data.segments()) {
+        EXPECT_LE(segment.size(), 64u);
+    }
+
+    auto flat = flatten(data);
+    ASSERT_EQ(flat.size(), payload.size() + 1);
+    EXPECT_EQ(flat[0], std::byte{1});
+    EXPECT_TRUE(std::equal(payload.begin(),
+                           payload.end(),
+                           reinterpret_cast<const char *>(flat.data() + 1)));
+}
+
+TEST(segmented_buffer, appends_across_archives)
+{
+    zpp::bits::chunk_pool pool(16);
+    zpp::bits::segmented_buffer data(pool);
+    for (int i = 0; i < 10; ++i) {
+        zpp::bits::out out(data);
+        out(i).or_throw();
+    }
+
+    auto flat = flatten(data);
+    zpp::bits::in in(flat);
+    for (int i = 0; i < 10; ++i) {
+        int value{};
+        in(value).or_throw();
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(in.remaining_data().size(), 0u);
+}
+
+TEST(segmented_buffer, chunks_are_reused)
+{
+    zpp::bits::chunk_pool pool(16);
+    {
+        zpp::bits::segmented_buffer data(pool);
+        zpp::bits::out out(data);
+        out(std::array<std::uint64_t, 8>{}).or_throw();
+    }
+    EXPECT_EQ(pool.available(), 4u);
+
+    zpp::bits::segmented_buffer data(pool);
+    zpp::bits::out out(data);
+    out(std::uint64_t{}).or_throw();
+    EXPECT_EQ(pool.available(), 3u);
+
+    data.clear();
+    EXPECT_EQ(pool.available(), 4u);
+    EXPECT_TRUE(data.empty());
+}
+
+TEST(segmented_buffer, alloc_limit)
+{
+    zpp::bits::chunk_pool pool(16);
+    zpp::bits::segmented_buffer data(pool);
+    zpp::bits::out out(data, zpp::bits::alloc_limit<32>{});
+    EXPECT_EQ(out(std::array<std::uint64_t, 5>{}),
+              std::errc::no_buffer_space);
+}
+
+struct pb_inner
+{
+    std::string text;
+};
+
+auto serialize(const pb_inner &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+struct pb_outer
+{
+    zpp::bits::vint32_t id;
+    pb_inner inner;
+    std::string text;
+};
+
+auto serialize(const pb_outer &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+class segmented_buffer_sized
+    : public ::testing::TestWithParam<std::size_t>
+{
+};
+
+TEST_P(segmented_buffer_sized, pb_matches_vector)
+{
+    pb_outer value{1337, {std::string(300, 'i')}, std::string(200, 'o')};
+
+    auto [expected, out_expected] = zpp::bits::data_out();
+    out_expected(value).or_throw();
+
+    zpp::bits::chunk_pool pool(GetParam());
+    zpp::bits::segmented_buffer data(pool);
+    zpp::bits::out out(data);
+    out(value).or_throw();
+
+    EXPECT_EQ(data.total_size(), expected.size());
+    EXPECT_EQ(encode_hex(flatten(data)), encode_hex(expected));
+
+    pb_outer decoded;
+    auto flat = flatten(data);
+    zpp::bits::in in(flat);
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.id, 1337);
+    EXPECT_EQ(decoded.inner.text, value.inner.text);
+    EXPECT_EQ(decoded.text, value.text);
+}
+
+TEST_P(segmented_buffer_sized, prefix_size_matches_vector)
+{
+    pb_outer value{1337, {std::string(300, 'i')}, std::string(200, 'o')};
+
+    auto [expected, out_expected] =
+        zpp::bits::data_out(zpp::bits::size_prefix_varint{});
+    out_expected(value).or_throw();
+
+    zpp::bits::chunk_pool pool(GetParam());
+    zpp::bits::segmented_buffer data(pool);
+    zpp::bits::out out(data, zpp::bits::size_prefix_varint{});
+    out(value).or_throw();
+
+    EXPECT_EQ(encode_hex(flatten(data)), encode_hex(expected));
+
+    pb_outer decoded;
+    auto flat = flatten(data);
+    zpp::bits::in in(flat, zpp::bits::size_prefix_varint{});
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded.id, 1337);
+    EXPECT_EQ(decoded.text, value.text);
+}
+
+INSTANTIATE_TEST_SUITE_P(segmented_buffer,
+                         segmented_buffer_sized,
+                         ::testing::Values(16, 64, 256, 0x10000));
+
+TEST(segmented_buffer, without_pool)
+{
+    zpp::bits::segmented_buffer data;
+    zpp::bits::out out(data);
+    out(std::vector<int>(0x10000, 1)).or_throw();
+
+    EXPECT_EQ(data.total_size(), 4u + 0x10000 * sizeof(int));
+    EXPECT_EQ(data.segments().size(), 5u);
+}
+
+} // namespace test_segmented_buffer
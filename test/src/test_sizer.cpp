@@ -0,0 +1,120 @@
+#include "test.h"
+#include <bitset>
+
+namespace test_sizer
+{
+
+struct person
+{
+    std::string name;
+    std::uint64_t id;
+    std::vector<std::uint32_t> numbers;
+    std::optional<std::map<int, std::string>> extra;
+    std::variant<int, std::string> tag;
+};
+
+person make_person()
+{
+    return {"name",
+            1234,
+            {1, 2, 3},
+            std::map<int, std::string>{{1, "one"}, {2, "two"}},
+            std::string("tag")};
+}
+
+TEST(sizer, matches_out)
+{
+    auto value = make_person();
+    auto [data, out] = zpp::bits::data_out();
+    out(value, std::bitset<20>{}, zpp::bits::vint64_t{-1}).or_throw();
+
+    zpp::bits::sizer sizer;
+    sizer(value, std::bitset<20>{}, zpp::bits::vint64_t{-1}).or_throw();
+    EXPECT_EQ(sizer.position(), data.size());
+}
+
+TEST(sizer, size_of_with_options)
+{
+    auto value = make_person();
+    auto [data, out] = zpp::bits::data_out(zpp::bits::size_varint{});
+    out(value).or_throw();
+
+    EXPECT_EQ(zpp::bits::size_of<zpp::bits::size_varint>(value).or_throw(),
+              data.size());
+    EXPECT_LT(zpp::bits::size_of<zpp::bits::size_varint>(value).or_throw(),
+              zpp::bits::size_of(value).or_throw());
+}
+
+TEST(sizer, errors)
+{
+    std::unique_ptr<int> pointer;
+    EXPECT_EQ(zpp::bits::size_of(pointer).error(),
+              std::errc::invalid_argument);
+    EXPECT_EQ(zpp::bits::to_vector_exact(pointer).error(),
+              std::errc::invalid_argument);
+}
+
+TEST(sizer, to_vector_exact)
+{
+    auto value = make_person();
+    auto [expected, out] = zpp::bits::data_out();
+    out(value, 1, 2).or_throw();
+
+    std::vector<std::byte> data =
+        zpp::bits::to_vector_exact(value, 1, 2).or_throw();
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(data.capacity(), data.size());
+
+    std::vector<char> chars =
+        zpp::bits::to_vector_exact<char>(std::string("abc")).or_throw();
+    EXPECT_EQ(encode_hex(chars), "03000000616263");
+}
+
+TEST(sizer, to_buffer_exact)
+{
+    auto value = make_person();
+    auto [expected, out] = zpp::bits::data_out();
+    out(value, 1, 2).or_throw();
+
+    zpp::bits::buffer<std::byte> data =
+        zpp::bits::to_buffer_exact(value, 1, 2).or_throw();
+    EXPECT_EQ(encode_hex(data), encode_hex(expected));
+    EXPECT_EQ(data.capacity(), data.size());
+}
+
+struct pb_inner
+{
+    std::string text;
+};
+
+auto serialize(const pb_inner &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+struct pb_outer
+{
+    zpp::bits::vint32_t id;
+    pb_inner inner;
+    std::vector<zpp::bits::vint32_t> numbers;
+};
+
+auto serialize(const pb_outer &) -> zpp::bits::protocol<zpp::bits::pb{}>;
+
+TEST(sizer, pb_protocol)
+{
+    pb_outer value{150, {std::string(200, 'x')}, {1, 300, 70000}};
+    auto [data, out] = zpp::bits::data_out();
+    out(value).or_throw();
+
+    EXPECT_EQ(zpp::bits::size_of(value).or_throw(), data.size());
+    EXPECT_EQ(zpp::bits::to_vector_exact(value).or_throw(), data);
+}
+
+constexpr auto constexpr_size()
+{
+    zpp::bits::sizer sizer;
+    sizer(std::tuple{1, std::byte{}, std::array<short, 3>{}}).or_throw();
+    return sizer.position();
+}
+
+static_assert(constexpr_size() == 11);
+
+} // namespace test_sizer
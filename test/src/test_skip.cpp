@@ -0,0 +1,212 @@
+#include "test.h"
+
+namespace test_skip
+{
+
+struct point
+{
+    int x;
+    int y;
+};
+
+// Fixed size, but not byte serializable due to padding.
+struct padded
+{
+    char c;
+    int i;
+};
+
+struct record
+{
+    std::string name;
+    std::vector<point> points;
+    std::optional<std::vector<std::string>> tags;
+    std::map<int, std::string> extra;
+    std::variant<int, std::string> tag;
+    std::tuple<char, std::string> pair;
+    zpp::bits::vint64_t score;
+    zpp::bits::lazy<std::string> lazy;
+};
+
+record make_record()
+{
+    return {"name",
+            {{1, 2}, {3, 4}},
+            std::vector<std::string>{"a", "bc"},
+            {{1, "one"}},
+            std::string("variant"),
+            {'c', "tuple"},
+            -5,
+            std::string("lazy")};
+}
+
+template <typename Type, typename... Options>
+void expect_skip(const Type & value, Options... options)
+{
+    auto [data, out] = zpp::bits::data_out(options...);
+    out(value, std::uint32_t{0x11223344}).or_throw();
+
+    zpp::bits::in in(data, Options{}...);
+    in.template skip<Type>().or_throw();
+    std::uint32_t last{};
+    in(last).or_throw();
+    EXPECT_EQ(last, 0x11223344u);
+    EXPECT_EQ(in.position(), data.size());
+}
+
+TEST(skip, types)
+{
+    expect_skip(std::uint64_t{1});
+    expect_skip(point{1, 2});
+    expect_skip(std::string("hello"));
+    expect_skip(std::vector<point>{{1, 2}, {3, 4}});
+    expect_skip(std::vector<std::string>{"a", "bc", ""});
+    expect_skip(std::optional<std::string>{});
+    expect_skip(std::optional<std::string>{"x"});
+    expect_skip(std::map<std::string, std::vector<int>>{{"a", {1}}});
+    expect_skip(std::array<std::string, 2>{"a", "b"});
+    expect_skip(make_record());
+    expect_skip(make_record(), zpp::bits::size_varint{});
+    expect_skip(make_record(), zpp::bits::endian::swapped{});
+    expect_skip(std::vector<std::uint64_t>{1, 2}, zpp::bits::align_arrays{});
+    expect_skip(std::vector<padded>{{'a', 1}, {'b', 2}});
+    expect_skip(std::vector<zpp::bits::varint<std::uint32_t,
+                                              zpp::bits::varint_encoding::group>>{
+        1, 300, 70000, 4, 5});
+}
+
+TEST(skip, fixed_size_elements)
+{
+    static_assert(!zpp::bits::concepts::byte_serializable<padded>);
+
+    // Sizes only, skipped without walking the elements.
+    auto [data, out] = zpp::bits::data_out();
+    out(std::uint32_t{1000}).or_throw();
+    data.resize(data.size() + 1000 * 5);
+
+    zpp::bits::in in(data);
+    in.skip<std::vector<padded>>().or_throw();
+    EXPECT_EQ(in.position(), data.size());
+
+    data.resize(data.size() - 1);
+    zpp::bits::in truncated(data);
+    EXPECT_EQ(truncated.skip<std::vector<padded>>(),
+              std::errc::result_out_of_range);
+    EXPECT_EQ(truncated.shortfall(), 1u);
+}
+
+struct counted
+{
+    inline static int decodes = 0;
+
+    int value;
+
+    constexpr static auto serialize(auto & archive, auto & self)
+    {
+        if constexpr (std::remove_cvref_t<decltype(archive)>::kind() ==
+                      zpp::bits::kind::in) {
+            ++decodes;
+        }
+        return archive(self.value);
+    }
+};
+
+TEST(skip, does_not_decode_walked_types)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::vector<counted>>{{{1}, {2}}, {{3}}}).or_throw();
+
+    counted::decodes = 0;
+    zpp::bits::in in(data);
+    in.skip<std::vector<std::vector<counted>>>().or_throw();
+    EXPECT_EQ(in.position(), data.size());
+    // Types with custom serialization are decoded.
+    EXPECT_EQ(counted::decodes, 3);
+
+    counted::decodes = 0;
+    zpp::bits::in string_in(data);
+    EXPECT_EQ(string_in.skip<std::string>(), std::errc{});
+    EXPECT_EQ(counted::decodes, 0);
+}
+
+TEST(skip, truncated)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(make_record()).or_throw();
+    data.resize(data.size() - 1);
+
+    zpp::bits::in in(data);
+    EXPECT_EQ(in.skip<record>(), std::errc::result_out_of_range);
+
+    std::vector<std::byte> bytes(3);
+    zpp::bits::in bytes_in(bytes);
+    EXPECT_EQ(bytes_in.skip<point>(), std::errc::result_out_of_range);
+    EXPECT_EQ(bytes_in.shortfall(), 5u);
+}
+
+TEST(skip, streaming)
+{
+    std::vector<char> payload(1000, 'x');
+    auto [data, out] = zpp::bits::data_out();
+    out(payload, std::uint8_t{7}).or_throw();
+
+    std::span<const std::byte> remaining = data;
+    zpp::bits::input_stream stream(
+        [&](std::span<std::byte> bytes) {
+            auto count = std::min<std::size_t>(bytes.size(), 10);
+            count = std::min(count, remaining.size());
+            std::copy_n(remaining.begin(), count, bytes.begin());
+            remaining = remaining.subspan(count);
+            return count;
+        },
+        16);
+    zpp::bits::in in(stream);
+    in.skip<std::vector<char>>().or_throw();
+    std::uint8_t last{};
+    in(last).or_throw();
+    EXPECT_EQ(last, 7);
+    EXPECT_LE(stream.capacity(), 16u);
+
+    remaining = std::span{data}.first(500);
+    zpp::bits::input_stream truncated_stream(
+        [&](std::span<std::byte> bytes) {
+            auto count = std::min(bytes.size(), remaining.size());
+            std::copy_n(remaining.begin(), count, bytes.begin());
+            remaining = remaining.subspan(count);
+            return count;
+        },
+        16);
+    zpp::bits::in truncated(truncated_stream);
+    EXPECT_EQ(truncated.skip<std::vector<char>>(),
+              std::errc::result_out_of_range);
+    EXPECT_EQ(truncated.shortfall(), 504u);
+}
+
+TEST(skip, streaming_commits)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::string>{"a", "bc"}, std::uint8_t{7}).or_throw();
+
+    std::span<const std::byte> remaining = data;
+    zpp::bits::input_stream stream(
+        [&](std::span<std::byte> bytes) {
+            auto count = std::min(bytes.size(), remaining.size());
+            std::copy_n(remaining.begin(), count, bytes.begin());
+            remaining = remaining.subspan(count);
+            return count;
+        },
+        64);
+    {
+        zpp::bits::in in(stream);
+        in.skip<std::vector<std::string>>().or_throw();
+    }
+
+    // A new archive continues after the skipped value.
+    zpp::bits::in in(stream);
+    std::uint8_t last{};
+    in(last).or_throw();
+    EXPECT_EQ(last, 7);
+    EXPECT_TRUE(stream.exhausted());
+}
+
+} // namespace test_skip
@@ -55,3 +55,13 @@ TEST(unordered_map, string)
         (std::unordered_map<std::string, std::string>{
             {"1"s, "1"s}, {"2"s, "2"s}, {"3"s, "3"s}, {"4"s, "4"s}}));
 }
+
+TEST(unordered_map, corrupted_size)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::uint32_t{0xffffffff}, 1, 1).or_throw();
+
+    std::unordered_map<int, int> s;
+    EXPECT_EQ(in(s), std::errc::result_out_of_range);
+    EXPECT_LT(s.bucket_count(), 0x100u);
+}
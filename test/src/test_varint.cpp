@@ -158,6 +158,48 @@ static_assert(
     zpp::bits::to_bytes<zpp::bits::varint<std::byte>{std::byte{0x7f}}>() ==
     "7f"_decode_hex);
 
+using vpuint32_t =
+    zpp::bits::varint<std::uint32_t, zpp::bits::varint_encoding::prefix>;
+using vpuint64_t =
+    zpp::bits::varint<std::uint64_t, zpp::bits::varint_encoding::prefix>;
+using vguint16_t =
+    zpp::bits::varint<std::uint16_t, zpp::bits::varint_encoding::group>;
+using vguint32_t =
+    zpp::bits::varint<std::uint32_t, zpp::bits::varint_encoding::group>;
+using vguint64_t =
+    zpp::bits::varint<std::uint64_t, zpp::bits::varint_encoding::group>;
+
+static_assert(zpp::bits::to_bytes<vpuint32_t{150}>() == "5a02"_decode_hex);
+static_assert(zpp::bits::from_bytes<"5a02"_decode_hex, vpuint32_t>() == 150);
+static_assert(zpp::bits::to_bytes<vpuint64_t{~0ull}>() ==
+              "00ffffffffffffffff"_decode_hex);
+static_assert(zpp::bits::from_bytes<"00ffffffffffffffff"_decode_hex,
+                                    vpuint64_t>() == ~0ull);
+static_assert(zpp::bits::to_bytes<vguint32_t{150}>() == "0096"_decode_hex);
+static_assert(zpp::bits::to_bytes<vguint32_t{0x12345}>() ==
+              "02452301"_decode_hex);
+static_assert(zpp::bits::to_bytes<vguint64_t{0x12345}>() ==
+              "0245230100"_decode_hex);
+static_assert(zpp::bits::from_bytes<"0245230100"_decode_hex, vguint64_t>() ==
+              0x12345);
+
+static_assert(zpp::bits::varint_size<zpp::bits::varint_encoding::prefix>(
+                  std::numeric_limits<std::uint64_t>::max()) == 9);
+static_assert(zpp::bits::varint_size<zpp::bits::varint_encoding::prefix>(
+                  std::uint64_t{1} << 55) == 8);
+static_assert(zpp::bits::varint_size<zpp::bits::varint_encoding::prefix>(
+                  std::numeric_limits<std::uint32_t>::max()) == 5);
+static_assert(zpp::bits::varint_size<zpp::bits::varint_encoding::group>(
+                  std::uint32_t{0x10000}) == 4);
+static_assert(zpp::bits::varint_size<zpp::bits::varint_encoding::group>(
+                  std::uint64_t{0x10000}) == 5);
+static_assert(zpp::bits::varint_max_size<std::uint64_t,
+                                         zpp::bits::varint_encoding::prefix> ==
+              9);
+static_assert(zpp::bits::varint_max_size<std::uint64_t,
+                                         zpp::bits::varint_encoding::group> ==
+              9);
+
 TEST(varint, sanity)
 {
     auto [data, in, out] = zpp::bits::data_in_out();
@@ -198,4 +240,493 @@ TEST(varint, varint_size)
     EXPECT_EQ(v, o);
 }
 
+std::vector<std::uint64_t> values_of_every_length()
+{
+    std::vector<std::uint64_t> values{0, std::numeric_limits<std::uint64_t>::max()};
+    for (int bits = 1; bits <= 64; ++bits) {
+        auto top = std::uint64_t{1} << (bits - 1);
+        values.push_back(top);
+        values.push_back(top | (top - 1));
+        values.push_back(top | ((0x5a5a5a5a5a5a5a5aull) & (top - 1)));
+    }
+    return values;
+}
+
+TEST(varint, decode_every_length)
+{
+    auto values = values_of_every_length();
+
+    auto [data, in, out] = zpp::bits::data_in_out();
+    for (auto value : values) {
+        out(zpp::bits::vuint64_t{value}).or_throw();
+    }
+    // Padding so that the last values are not decoded by the short input path.
+    out(std::array<std::byte, 16>{}).or_throw();
+
+    for (auto value : values) {
+        zpp::bits::vuint64_t decoded;
+        auto position = in.position();
+        in(decoded).or_throw();
+        EXPECT_EQ(decoded, value);
+        EXPECT_EQ(in.position() - position,
+                  zpp::bits::varint_size(value));
+    }
+}
+
+TEST(varint, decode_too_long)
+{
+    auto data = "ffffffffffffffffffff01"_decode_hex;
+    std::array<std::byte, 16> padded{};
+    std::copy(data.begin(), data.end(), padded.begin());
+
+    zpp::bits::vuint64_t value;
+    EXPECT_EQ(zpp::bits::in{padded}(value), std::errc::value_too_large);
+}
+
+TEST(varint, decode_ignores_excess_bits_of_tenth_byte)
+{
+    auto data = "ffffffffffffffffff7f"_decode_hex;
+    std::array<std::byte, 16> padded{};
+    std::copy(data.begin(), data.end(), padded.begin());
+
+    zpp::bits::vuint64_t value;
+    zpp::bits::in in{padded};
+    in(value).or_throw();
+    EXPECT_EQ(value, std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(in.position(), 10u);
+}
+
+std::vector<std::byte> encode_bytewise(std::uint64_t value)
+{
+    std::vector<std::byte> bytes;
+    while (value >= 0x80) {
+        bytes.push_back(std::byte((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(std::byte(value));
+    return bytes;
+}
+
+TEST(varint, encode_every_length)
+{
+    for (auto value : values_of_every_length()) {
+        auto expected = encode_bytewise(value);
+
+        auto [data, out] = zpp::bits::data_out();
+        out(zpp::bits::vuint64_t{value}).or_throw();
+        EXPECT_EQ(data, expected);
+
+        // Exactly as much room as needed, which leaves no room for the
+        // word stores.
+        std::vector<std::byte> tight(expected.size());
+        zpp::bits::out tight_out{tight};
+        tight_out(zpp::bits::vuint64_t{value}).or_throw();
+        EXPECT_EQ(tight, expected);
+        EXPECT_EQ(tight_out.position(), expected.size());
+
+        if (value <= std::numeric_limits<std::uint32_t>::max()) {
+            auto [data32, out32] = zpp::bits::data_out();
+            out32(zpp::bits::vuint32_t{std::uint32_t(value)}).or_throw();
+            EXPECT_EQ(data32, expected);
+        }
+    }
+}
+
+TEST(varint, encode_keeps_bytes_after_position)
+{
+    std::array<std::byte, 64> data{};
+    zpp::bits::out out{data};
+    out.position() = 4;
+    out(std::uint32_t{0xdeadbeef}).or_throw();
+    out.position() = 0;
+    out(zpp::bits::vuint32_t{5}).or_throw();
+    EXPECT_EQ(encode_hex(std::span{data}.first(8)), "05000000efbeadde");
+
+    std::vector<std::byte> vector_data;
+    zpp::bits::out vector_out{vector_data};
+    vector_out(std::uint32_t{0}, std::uint32_t{0xdeadbeef}).or_throw();
+    vector_out.position() = 0;
+    vector_out(zpp::bits::vuint64_t{5}).or_throw();
+    EXPECT_EQ(encode_hex(std::span{vector_data}.first(8)), "05000000efbeadde");
+
+    // Bytes the vector held before the archive are kept as well.
+    std::vector<std::byte> existing(16, std::byte{0xff});
+    zpp::bits::out existing_out{existing};
+    existing_out(zpp::bits::vuint64_t{5}).or_throw();
+    EXPECT_EQ(existing[0], std::byte{5});
+    EXPECT_EQ(existing[1], std::byte{0xff});
+
+    // Runs of varints do not write past their end either.
+    std::vector<std::uint32_t> values{5};
+    std::array<std::byte, 64> span_data{};
+    zpp::bits::out span_out{span_data};
+    span_out.position() = 4;
+    span_out(std::uint32_t{0xdeadbeef}).or_throw();
+    span_out.position() = 0;
+    span_out(zpp::bits::varint_span(values)).or_throw();
+    EXPECT_EQ(encode_hex(std::span{span_data}.first(8)), "05000000efbeadde");
+
+    std::vector<std::uint64_t> run(20, 0x1234);
+    std::vector<std::byte> run_data(64, std::byte{0xff});
+    zpp::bits::out run_out{run_data};
+    run_out(zpp::bits::varint_span(run)).or_throw();
+    EXPECT_EQ(encode_hex(std::span{run_data}.subspan(36, 6)), "b424b424ffff");
+}
+
+TEST(varint, encode_keeps_following_values)
+{
+    auto values = values_of_every_length();
+    std::vector<std::byte> expected;
+    for (auto value : values) {
+        auto bytes = encode_bytewise(value);
+        expected.insert(expected.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<std::byte> data(expected.size());
+    zpp::bits::out out{data};
+    for (auto value : values) {
+        out(zpp::bits::vuint64_t{value}).or_throw();
+    }
+    EXPECT_EQ(data, expected);
+}
+
+TEST(varint, varint_span)
+{
+    auto values = values_of_every_length();
+    // Runs of small values take the word at a time path.
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        values.push_back(i % 0x80);
+    }
+
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(zpp::bits::varint_span(values)).or_throw();
+
+    std::vector<std::byte> expected;
+    for (auto value : values) {
+        auto bytes = encode_bytewise(value);
+        expected.insert(expected.end(), bytes.begin(), bytes.end());
+    }
+    EXPECT_EQ(data, expected);
+
+    std::vector<std::uint64_t> decoded(values.size());
+    in(zpp::bits::varint_span(decoded)).or_throw();
+    EXPECT_EQ(decoded, values);
+    EXPECT_EQ(in.position(), data.size());
+}
+
+TEST(varint, varint_span_of_varints)
+{
+    enum class small : std::int16_t
+    {
+    };
+
+    std::vector<zpp::bits::vsint32_t> integers;
+    std::vector<small> enums;
+    for (int i = -300; i < 300; ++i) {
+        integers.push_back(i * (i % 3 ? 1 : 4099));
+        enums.push_back(small(i));
+    }
+
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(zpp::bits::varint_span(integers), zpp::bits::varint_span(enums))
+        .or_throw();
+
+    auto [expected, expected_out] = zpp::bits::data_out();
+    for (auto integer : integers) {
+        expected_out(integer).or_throw();
+    }
+    for (auto value : enums) {
+        expected_out(zpp::bits::varint{value}).or_throw();
+    }
+    EXPECT_EQ(data, expected);
+
+    std::vector<zpp::bits::vsint32_t> decoded_integers(integers.size());
+    std::vector<small> decoded_enums(enums.size());
+    in(zpp::bits::varint_span(decoded_integers),
+       zpp::bits::varint_span(decoded_enums))
+        .or_throw();
+    EXPECT_EQ(decoded_integers, integers);
+    EXPECT_EQ(decoded_enums, enums);
+}
+
+TEST(varint, varint_span_errors)
+{
+    std::vector<std::uint32_t> values{1, 2, 300, 4};
+
+    std::array<std::byte, 4> small{};
+    EXPECT_EQ(zpp::bits::out{small}(zpp::bits::varint_span(values)),
+              std::errc::result_out_of_range);
+
+    auto data = "0102ac02"_decode_hex;
+    std::vector<std::uint32_t> decoded(values.size());
+    EXPECT_EQ(zpp::bits::in{data}(zpp::bits::varint_span(decoded)),
+              std::errc::result_out_of_range);
+
+    auto too_long = "01ffffffffff"_decode_hex;
+    EXPECT_EQ(zpp::bits::in{too_long}(zpp::bits::varint_span(decoded)),
+              std::errc::value_too_large);
+
+    // Too long for 32 bits, yet ending within a word.
+    auto too_long_padded = "01ffffffffff0100000000"_decode_hex;
+    EXPECT_EQ(
+        zpp::bits::in{too_long_padded}(zpp::bits::varint_span(decoded)),
+        std::errc::value_too_large);
+}
+
+TEST(varint, count_varints)
+{
+    auto data = "01ac0280808001ff7f0203"_decode_hex;
+    EXPECT_EQ(zpp::bits::kernels::count_varints(data.data(), data.size()),
+              6u);
+    EXPECT_EQ(zpp::bits::kernels::count_varints(data.data(), 9), 4u);
+}
+
+std::vector<std::byte> encode_prefix_bytewise(std::uint64_t value)
+{
+    std::vector<std::byte> bytes;
+    auto size = zpp::bits::varint_size(value);
+    if (size > 8) {
+        bytes.push_back(std::byte{});
+        size = 8;
+    } else {
+        value = (value << size) | (std::uint64_t{1} << (size - 1));
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes.push_back(std::byte(value >> (8 * i)));
+    }
+    return bytes;
+}
+
+TEST(varint, prefix_every_length)
+{
+    auto values = values_of_every_length();
+    std::vector<std::byte> expected;
+    for (auto value : values) {
+        auto bytes = encode_prefix_bytewise(value);
+        expected.insert(expected.end(), bytes.begin(), bytes.end());
+
+        std::vector<std::byte> tight(bytes.size());
+        zpp::bits::out tight_out{tight};
+        tight_out(vpuint64_t{value}).or_throw();
+        EXPECT_EQ(tight, bytes);
+
+        vpuint64_t decoded;
+        zpp::bits::in tight_in{tight};
+        tight_in(decoded).or_throw();
+        EXPECT_EQ(decoded, value);
+        EXPECT_EQ(tight_in.position(), bytes.size());
+
+        if (value <= std::numeric_limits<std::uint32_t>::max()) {
+            auto [data32, in32, out32] = zpp::bits::data_in_out();
+            out32(vpuint32_t{std::uint32_t(value)}).or_throw();
+            EXPECT_EQ(data32, bytes);
+            vpuint32_t decoded32;
+            in32(decoded32).or_throw();
+            EXPECT_EQ(decoded32, value);
+        }
+    }
+
+    auto [data, in, out] = zpp::bits::data_in_out();
+    for (auto value : values) {
+        out(vpuint64_t{value}).or_throw();
+    }
+    EXPECT_EQ(data, expected);
+    for (auto value : values) {
+        vpuint64_t decoded;
+        in(decoded).or_throw();
+        EXPECT_EQ(decoded, value);
+    }
+    EXPECT_EQ(in.position(), data.size());
+}
+
+TEST(varint, group_every_length)
+{
+    for (auto value : values_of_every_length()) {
+        auto size = std::size_t(std::bit_width(value | 1) + 7) / 8;
+        auto length = std::bit_ceil(size);
+        std::vector<std::byte> expected{std::byte(std::countr_zero(length))};
+        for (std::size_t i = 0; i < length; ++i) {
+            expected.push_back(std::byte(value >> (8 * i)));
+        }
+
+        std::vector<std::byte> tight(expected.size());
+        zpp::bits::out{tight}(vguint64_t{value}).or_throw();
+        EXPECT_EQ(tight, expected);
+
+        vguint64_t decoded;
+        zpp::bits::in{tight}(decoded).or_throw();
+        EXPECT_EQ(decoded, value);
+
+        if (value <= std::numeric_limits<std::uint32_t>::max()) {
+            std::vector<std::byte> expected32{std::byte(size - 1)};
+            expected32.insert(
+                expected32.end(), expected.begin() + 1,
+                expected.begin() + 1 + std::ptrdiff_t(size));
+            auto [data32, in32, out32] = zpp::bits::data_in_out();
+            out32(vguint32_t{std::uint32_t(value)}).or_throw();
+            EXPECT_EQ(data32, expected32);
+            vguint32_t decoded32;
+            in32(decoded32).or_throw();
+            EXPECT_EQ(decoded32, value);
+        }
+    }
+}
+
+TEST(varint, group_containers)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    std::vector<vguint32_t> values{1, 300, 70000, 1u << 30, 5};
+    out(values).or_throw();
+    EXPECT_EQ(encode_hex(data), "05000000e4012c01701101000000400005");
+    EXPECT_EQ(zpp::bits::size_of(values).or_throw(), data.size());
+
+    std::vector<vguint32_t> decoded;
+    in(decoded).or_throw();
+    EXPECT_EQ(decoded, values);
+
+    auto every_length = values_of_every_length();
+    for (auto count : {0u, 1u, 4u, 7u}) {
+        std::vector<std::uint64_t> integers(every_length.end() - count,
+                                            every_length.end());
+        auto [data64, in64, out64] = zpp::bits::data_in_out();
+        out64(zpp::bits::varint_span<std::uint64_t,
+                                     zpp::bits::varint_encoding::group>(
+                  integers))
+            .or_throw();
+
+        std::vector<vguint64_t> varints(integers.begin(), integers.end());
+        auto [expected, out_expected] = zpp::bits::data_out();
+        out_expected(zpp::bits::unsized(varints)).or_throw();
+        EXPECT_EQ(data64, expected);
+
+        std::vector<std::uint64_t> decoded64(count);
+        in64(zpp::bits::varint_span<std::uint64_t,
+                                    zpp::bits::varint_encoding::group>(
+                 decoded64))
+            .or_throw();
+        EXPECT_EQ(decoded64, integers);
+        EXPECT_EQ(in64.position(), data64.size());
+    }
+
+    std::array<vguint16_t, 3> array{1, 0x100, 2};
+    auto [data16, in16, out16] = zpp::bits::data_in_out();
+    out16(array).or_throw();
+    EXPECT_EQ(encode_hex(data16), "0401000102");
+    std::array<vguint16_t, 3> decoded16{};
+    in16(decoded16).or_throw();
+    EXPECT_EQ(decoded16, array);
+}
+
+TEST(varint, prefix_and_group_errors)
+{
+    vpuint32_t prefix32;
+    vpuint64_t prefix64;
+    auto truncated = "5a"_decode_hex;
+    EXPECT_EQ(zpp::bits::in{truncated}(prefix32),
+              std::errc::result_out_of_range);
+    auto nine_bytes = "00ffffffffffffffff"_decode_hex;
+    EXPECT_EQ(zpp::bits::in{nine_bytes}(prefix32), std::errc::value_too_large);
+    EXPECT_EQ(zpp::bits::in{std::span{nine_bytes}.first(8)}(prefix64),
+              std::errc::result_out_of_range);
+
+    vguint32_t group32;
+    vguint16_t group16;
+    auto group_truncated = "03ffffff"_decode_hex;
+    EXPECT_EQ(zpp::bits::in{group_truncated}(group32),
+              std::errc::result_out_of_range);
+    auto group_too_long = "02ffffff00"_decode_hex;
+    EXPECT_EQ(zpp::bits::in{group_too_long}(group16),
+              std::errc::value_too_large);
+
+    std::vector<std::uint32_t> values{1, 2, 300, 4, 5};
+    std::array<std::byte, 6> small{};
+    EXPECT_EQ(zpp::bits::out{small}(
+                  zpp::bits::varint_span<std::uint32_t,
+                                         zpp::bits::varint_encoding::group>(
+                      values)),
+              std::errc::result_out_of_range);
+    EXPECT_EQ(zpp::bits::out{small}(vpuint64_t{~0ull}),
+              std::errc::result_out_of_range);
+}
+
+TEST(varint, prefix_and_group_keep_bytes_after_position)
+{
+    auto patched = [](auto && item) {
+        std::array<std::byte, 64> data{};
+        zpp::bits::out out{data, zpp::bits::size_prefix_varint{}};
+        out.position() = 4;
+        out(std::uint32_t{0xdeadbeef}).or_throw();
+        out.position() = 0;
+        out(item).or_throw();
+        return encode_hex(std::span{data}.first(8));
+    };
+    EXPECT_EQ(patched(vpuint64_t{5}), "0b000000efbeadde");
+    EXPECT_EQ(patched(vguint64_t{5}), "00050000efbeadde");
+    EXPECT_EQ(patched(std::string{}), "01000000efbeadde");
+
+    std::vector<std::uint64_t> values{5, 6};
+    std::vector<std::byte> prefix_data(64, std::byte{0xff});
+    zpp::bits::out prefix_out{prefix_data};
+    prefix_out(zpp::bits::varint_span<std::uint64_t,
+                                      zpp::bits::varint_encoding::prefix>(
+                   values))
+        .or_throw();
+    EXPECT_EQ(encode_hex(std::span{prefix_data}.first(3)), "0b0dff");
+
+    std::vector<std::byte> group_data(64, std::byte{0xff});
+    zpp::bits::out group_out{group_data};
+    group_out(zpp::bits::varint_span<std::uint64_t,
+                                     zpp::bits::varint_encoding::group>(
+                  values))
+        .or_throw();
+    EXPECT_EQ(encode_hex(std::span{group_data}.first(4)), "000506ff");
+}
+
+TEST(varint, size_prefix_varint)
+{
+    auto [data, in, out] = data_in_out(zpp::bits::size_prefix_varint{});
+    std::string text(200, 'x');
+    std::vector<std::vector<int>> vectors{{1, 2}, {3}, std::vector<int>(100)};
+    out(text, vectors).or_throw();
+    EXPECT_EQ(encode_hex(std::span{data}.first(2)), "2203");
+    EXPECT_EQ(zpp::bits::size_of<zpp::bits::size_prefix_varint>(text, vectors)
+                  .or_throw(),
+              data.size());
+
+    std::string decoded_text;
+    std::vector<std::vector<int>> decoded_vectors;
+    in(decoded_text, decoded_vectors).or_throw();
+    EXPECT_EQ(decoded_text, text);
+    EXPECT_EQ(decoded_vectors, vectors);
+
+    auto [group_data, group_in, group_out] = zpp::bits::data_in_out();
+    zpp::bits::sized_t<std::vector<char>, vguint32_t> sized(text.begin(),
+                                                            text.end());
+    group_out(sized).or_throw();
+    EXPECT_EQ(encode_hex(std::span{group_data}.first(2)), "00c8");
+    EXPECT_EQ(group_data.size(), 2 + text.size());
+    decltype(sized) decoded_sized;
+    group_in(decoded_sized).or_throw();
+    EXPECT_EQ(decoded_sized, sized);
+}
+
+#if ZPP_BITS_X86_KERNELS
+TEST(varint, bmi2_kernel)
+{
+    if (!__builtin_cpu_supports("bmi2")) {
+        GTEST_SKIP();
+    }
+
+    for (auto value : values_of_every_length()) {
+        std::array<std::byte, 16> data{};
+        zpp::bits::out{data}(zpp::bits::vuint64_t{value}).or_throw();
+
+        std::uint64_t decoded{};
+        EXPECT_EQ(zpp::bits::kernels::decode_varint_bmi2(data.data(), decoded),
+                  zpp::bits::varint_size(value));
+        EXPECT_EQ(decoded, value);
+    }
+}
+#endif
+
 } // namespace test_varint
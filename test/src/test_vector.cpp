@@ -192,4 +192,100 @@ TEST(vector, vector1b)
     EXPECT_EQ(v, (std::vector{1,2,3,4}));
 }
 
+TEST(vector, replaces_existing_elements)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::vector{1, 2}, std::vector{3, 4, 5, 6, 7, 8, 9, 10}).or_throw();
+
+    std::vector<int> v{11, 12, 13, 14, 15};
+    auto capacity = v.capacity();
+    auto elements = v.data();
+    in(v).or_throw();
+    EXPECT_EQ(v, (std::vector{1, 2}));
+    EXPECT_EQ(v.capacity(), capacity);
+    EXPECT_EQ(v.data(), elements);
+
+    in(v).or_throw();
+    EXPECT_EQ(v, (std::vector{3, 4, 5, 6, 7, 8, 9, 10}));
+}
+
+TEST(vector, truncated)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::vector{1, 2, 3, 4}).or_throw();
+    data.resize(data.size() - 1);
+
+    std::vector<int> v;
+    EXPECT_EQ(in(v), std::errc::result_out_of_range);
+}
+
+TEST(vector, unchanged_on_failure)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::vector<std::string>{"a", "b", "c"}).or_throw();
+    data.resize(data.size() - 1);
+
+    std::vector<std::string> v{"d", "e"};
+    EXPECT_EQ(in(v), std::errc::result_out_of_range);
+    EXPECT_EQ(v, (std::vector<std::string>{"d", "e"}));
+}
+
+TEST(vector, corrupted_size)
+{
+    auto [data, in, out] = zpp::bits::data_in_out();
+    out(std::uint32_t{0xffffffff}, std::string(100, 'a')).or_throw();
+
+    std::vector<std::string> v;
+    EXPECT_EQ(in(v), std::errc::result_out_of_range);
+    EXPECT_TRUE(v.empty());
+
+    // The input holds at most 104 / 4 strings.
+    zpp::bits::in reuse_in(data, zpp::bits::reuse{});
+    EXPECT_EQ(reuse_in(v), std::errc::result_out_of_range);
+    EXPECT_LE(v.capacity(), 26u);
+}
+
+TEST(vector, reuse_keeps_elements_and_capacity)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::string>{"a string longer than the small buffer",
+                                 "b",
+                                 "c"})
+        .or_throw();
+
+    std::vector<std::string> v{"another string longer than the small buffer",
+                               "d"};
+    v.reserve(8);
+    auto elements = v.data();
+    auto text = v[0].data();
+    zpp::bits::in{data, zpp::bits::reuse{}}(v).or_throw();
+    EXPECT_EQ(v,
+              (std::vector<std::string>{
+                  "a string longer than the small buffer", "b", "c"}));
+    EXPECT_EQ(v.data(), elements);
+    EXPECT_EQ(v[0].data(), text);
+
+    auto [shorter, shorter_out] = zpp::bits::data_out();
+    shorter_out(std::vector<std::string>{"e"}).or_throw();
+    zpp::bits::in{shorter, zpp::bits::reuse{}}(v).or_throw();
+    EXPECT_EQ(v, (std::vector<std::string>{"e"}));
+    EXPECT_EQ(v.data(), elements);
+}
+
+TEST(vector, reuse_decodes_into_elements)
+{
+    auto [data, out] = zpp::bits::data_out();
+    out(std::vector<std::string>{"a string longer than the small buffer"})
+        .or_throw();
+
+    std::vector<std::string> v{"another string longer than the small buffer",
+                               "b"};
+    auto text = v[0].data();
+    zpp::bits::in{data, zpp::bits::reuse{}}(v).or_throw();
+    EXPECT_EQ(v,
+              (std::vector<std::string>{
+                  "a string longer than the small buffer"}));
+    EXPECT_EQ(v[0].data(), text);
+}
+
 } // namespace test_vector
@@ -4,11 +4,14 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <bitset>
 #include <climits>
 #include <compare>
 #include <concepts>
 #include <cstddef>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
@@ -23,6 +26,14 @@
 #include <utility>
 #include <variant>
 #include <vector>
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #if __has_include("zpp_throwing.h")
 #include "zpp_throwing.h"
 #endif
@@ -65,6 +76,19 @@
 #define ZPP_BITS_INLINE_DECODE_VARINT (0)
 #endif
 
+#ifndef ZPP_BITS_X86_KERNELS
+#if (defined __x86_64__ || defined __i386__) &&                              \
+    (defined __clang__ || defined __GNUC__) && __has_include(<immintrin.h>)
+#define ZPP_BITS_X86_KERNELS (1)
+#else
+#define ZPP_BITS_X86_KERNELS (0)
+#endif
+#endif
+
+#if ZPP_BITS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace zpp::bits
 {
 using default_size_type = std::uint32_t;
@@ -390,6 +414,25 @@ struct is_shared_ptr<std::shared_ptr<Type>> : std::true_type
 {
 };
 
+// Whether the object representation of Type is a std::bitset's bits in
+// serialized order, lowest first, as the words of the common standard
+// libraries are on little endian.
+template <typename Type>
+constexpr bool bitset_bytes_in_order()
+{
+#if defined __GLIBCXX__ || defined _LIBCPP_VERSION || defined _MSVC_STL_VERSION
+    if constexpr (requires {
+                      requires std::same_as<Type,
+                                            std::bitset<Type{}.size()>>;
+                  }) {
+        return std::endian::native == std::endian::little &&
+               std::is_trivially_copyable_v<Type> &&
+               sizeof(Type) * CHAR_BIT >= Type{}.size();
+    }
+#endif
+    return false;
+}
+
 template <typename Variant>
 struct variant_impl;
 
@@ -612,6 +655,12 @@ struct visitor
     [[no_unique_address]] Visitor visitor;
 };
 
+template <typename Archive>
+constexpr auto is_visitor = false;
+
+template <typename Type, typename Visitor>
+constexpr auto is_visitor<visitor<Type, Visitor>> = true;
+
 constexpr auto get_default_size_type()
 {
     return default_size_type{};
@@ -766,6 +815,11 @@ concept byte_view = byte_type<typename std::remove_cvref_t<Type>::value_type> &&
     value.size();
 };
 
+// The archive passed to explicit serialize functions to visit the members
+// of a type, whose calls return the result of the visitor, not errc.
+template <typename Archive>
+concept member_visitor = traits::is_visitor<std::remove_cvref_t<Archive>>;
+
 template <typename Type>
 concept has_serialize =
     access::has_serialize<Type,
@@ -833,6 +887,15 @@ concept bitset =
     bitset.to_ullong();
 };
 
+template <typename Type>
+concept bit_vector =
+    container<Type> && requires(std::remove_cvref_t<Type> bits)
+{
+    requires std::same_as<typename std::remove_cvref_t<Type>::value_type,
+                          bool>;
+    bits.flip();
+};
+
 template <typename Type>
 concept has_protocol = access::has_protocol<Type>();
 
@@ -1019,198 +1082,1012 @@ constexpr auto as_bytes(auto && object)
     return bytes(std::span{&object, 1});
 }
 
-template <typename Option>
-struct option
+template <concepts::byte_type ByteType = std::byte>
+class buffer
 {
-    using zpp_bits_option = void;
-    constexpr auto operator()(auto && archive)
+public:
+    using value_type = ByteType;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ByteType *;
+    using const_pointer = const ByteType *;
+    using reference = ByteType &;
+    using const_reference = const ByteType &;
+    using iterator = ByteType *;
+    using const_iterator = const ByteType *;
+
+    constexpr buffer() = default;
+
+    constexpr explicit buffer(std::size_t size)
     {
-        if constexpr (requires {
-                          archive.option(static_cast<Option &>(*this));
-                      }) {
-            archive.option(static_cast<Option &>(*this));
+        resize(size);
+    }
+
+    constexpr buffer(const buffer & other)
+    {
+        resize(other.m_size);
+        std::copy_n(other.m_data, other.m_size, m_data);
+    }
+
+    constexpr buffer(buffer && other) noexcept :
+        m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    constexpr buffer & operator=(const buffer & other)
+    {
+        if (this != std::addressof(other)) {
+            m_size = 0;
+            resize(other.m_size);
+            std::copy_n(other.m_data, other.m_size, m_data);
         }
+        return *this;
     }
-};
 
-inline namespace options
-{
-struct append : option<append>
-{
-};
+    constexpr buffer & operator=(buffer && other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        return *this;
+    }
 
-struct reserve : option<reserve>
-{
-    constexpr explicit reserve(std::size_t size) : size(size)
+    constexpr ~buffer()
     {
+        delete[] m_data;
     }
-    std::size_t size{};
-};
 
-struct resize : option<resize>
-{
-    constexpr explicit resize(std::size_t size) : size(size)
+    constexpr auto data()
     {
+        return m_data;
     }
-    std::size_t size{};
-};
 
-template <std::size_t Size>
-struct alloc_limit : option<alloc_limit<Size>>
-{
-    constexpr static auto alloc_limit_value = Size;
-};
+    constexpr auto data() const
+    {
+        return static_cast<const ByteType *>(m_data);
+    }
 
-template <std::size_t Multiplier, std::size_t Divisor = 1>
-struct enlarger : option<enlarger<Multiplier, Divisor>>
-{
-    constexpr static auto enlarger_value =
-        std::tuple{Multiplier, Divisor};
-};
+    constexpr std::size_t size() const
+    {
+        return m_size;
+    }
 
-using exact_enlarger = enlarger<1, 1>;
+    constexpr std::size_t capacity() const
+    {
+        return m_capacity;
+    }
 
-namespace endian
-{
-struct big : option<big>
-{
-    constexpr static auto value = std::endian::big;
-};
+    constexpr bool empty() const
+    {
+        return !m_size;
+    }
 
-struct little : option<little>
-{
-    constexpr static auto value = std::endian::little;
-};
+    constexpr auto begin()
+    {
+        return data();
+    }
 
-using network = big;
+    constexpr auto begin() const
+    {
+        return data();
+    }
 
-using native = std::
-    conditional_t<std::endian::native == std::endian::little, little, big>;
+    constexpr auto end()
+    {
+        return data() + m_size;
+    }
 
-using swapped = std::
-    conditional_t<std::endian::native == std::endian::little, big, little>;
-} // namespace endian
+    constexpr auto end() const
+    {
+        return data() + m_size;
+    }
 
-struct no_fit_size : option<no_fit_size>
-{
-};
+    constexpr auto & operator[](std::size_t index)
+    {
+        return m_data[index];
+    }
 
-struct no_enlarge_overflow : option<no_enlarge_overflow>
-{
-};
+    constexpr auto & operator[](std::size_t index) const
+    {
+        return std::as_const(m_data[index]);
+    }
 
-struct enlarge_overflow : option<enlarge_overflow>
-{
-};
+    // Unlike standard containers, growing leaves the new bytes
+    // uninitialized and shrinking never reallocates. Growing allocates
+    // exactly the size, the growth factor is left to the enlarger of the
+    // output archive.
+    constexpr void resize(std::size_t size)
+    {
+        if (size > m_capacity) {
+            reallocate(size);
+        }
+        m_size = size;
+    }
 
-struct no_size : option<no_size>
-{
-    using default_size_type = void;
-};
+    constexpr void reserve(std::size_t capacity)
+    {
+        if (capacity > m_capacity) {
+            reallocate(capacity);
+        }
+    }
 
-struct size1b : option<size1b>
-{
-    using default_size_type = unsigned char;
-};
+    constexpr void clear()
+    {
+        m_size = 0;
+    }
 
-struct size2b : option<size2b>
-{
-    using default_size_type = std::uint16_t;
-};
+    constexpr friend bool operator==(const buffer & left,
+                                     const buffer & right)
+    {
+        return std::equal(
+            left.begin(), left.end(), right.begin(), right.end());
+    }
 
-struct size4b : option<size4b>
-{
-    using default_size_type = std::uint32_t;
-};
+private:
+    constexpr void reallocate(std::size_t capacity)
+    {
+        auto data = std::is_constant_evaluated() ? new ByteType[capacity]()
+                                                 : new ByteType[capacity];
+        std::copy_n(m_data, m_size, data);
+        delete[] m_data;
+        m_data = data;
+        m_capacity = capacity;
+    }
 
-struct size8b : option<size8b>
-{
-    using default_size_type = std::uint64_t;
+    ByteType * m_data{};
+    std::size_t m_size{};
+    std::size_t m_capacity{};
 };
 
-struct size_native : option<size_native>
+template <concepts::byte_type ByteType = std::byte>
+class chunk_pool
 {
-    using default_size_type = std::size_t;
-};
+public:
+    constexpr static std::size_t default_chunk_size = 0x10000;
 
-template <typename Protocol>
-struct protocol_option : option<protocol_option<Protocol>> {
-    using protocol_type = Protocol;
-};
-} // namespace options
+    explicit chunk_pool(std::size_t chunk_size = default_chunk_size) :
+        m_chunk_size(chunk_size)
+    {
+    }
 
-namespace concepts {
-    template <typename Option>
-    concept is_protocol_option = requires {
-        requires std::same_as<std::remove_cvref_t<Option>, protocol_option<typename Option::protocol_type>>;
-    };
-}
+    chunk_pool(const chunk_pool &) = delete;
+    chunk_pool & operator=(const chunk_pool &) = delete;
 
-struct any
-{
-    template <typename Type>
-    operator Type() 
-#if ZPP_BITS_AUTODETECT_MEMBERS_MODE == 0
-    requires (! concepts::optional<Type>)
-#endif
-    ;
+    std::size_t chunk_size() const
+    {
+        return m_chunk_size;
+    }
+
+    std::size_t available() const
+    {
+        return m_chunks.size();
+    }
+
+    std::unique_ptr<ByteType[]> acquire()
+    {
+        if (m_chunks.empty()) {
+            return std::make_unique_for_overwrite<ByteType[]>(m_chunk_size);
+        }
+        auto chunk = std::move(m_chunks.back());
+        m_chunks.pop_back();
+        return chunk;
+    }
+
+    void release(std::unique_ptr<ByteType[]> chunk)
+    {
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    void shrink()
+    {
+        m_chunks.clear();
+        m_chunks.shrink_to_fit();
+    }
+
+private:
+    std::size_t m_chunk_size{};
+    std::vector<std::unique_ptr<ByteType[]>> m_chunks;
 };
 
-template <typename Type>
-constexpr auto access::number_of_members()
+// A rope of chunks taken from a chunk_pool. Output archives write into the
+// free window of the current chunk, which is what data() and size() refer
+// to, and move on to a new chunk when it fills up, so written bytes are
+// never copied. The written bytes are exposed by segments().
+template <concepts::byte_type ByteType = std::byte>
+class segmented_buffer
 {
-    using type = std::remove_cvref_t<Type>;
-    if constexpr (std::is_array_v<type>) {
-        return std::extent_v<type>;
-    } else if constexpr (!std::is_class_v<type>) {
-        return 0;
-    } else if constexpr (concepts::container<type> && requires {
-                             std::integral_constant<
-                                 std::size_t,
-                                 type{}.size()>::value != 0;
-                         }) {
-        return type{}.size();
-    } else if constexpr (concepts::tuple<type>) {
-        return std::tuple_size_v<type>;
-    } else if constexpr (requires {
-                             requires std::same_as<
-                                 typename type::serialize,
-                                 members<type::serialize::value>>;
-                             requires type::serialize::value !=
-                                 std::numeric_limits<
-                                     std::size_t>::max();
-                         }) {
-        return type::serialize::value;
-    } else if constexpr (requires(Type && item) {
-                             requires std::same_as<
-                                 decltype(serialize(item)),
-                                 members<decltype(serialize(
-                                     item))::value>>;
-                             requires decltype(serialize(
-                                 item))::value !=
-                                 std::numeric_limits<
-                                     std::size_t>::max();
-                         }) {
-        return decltype(serialize(std::declval<type>()))::value;
-    } else if constexpr (requires {
-                             requires std::same_as<
-                                 typename type::serialize,
-                                 protocol<type::serialize::value,
-                                          type::serialize::members>>;
-                             requires type::serialize::members !=
-                                 std::numeric_limits<
-                                     std::size_t>::max();
-                         }) {
-        return type::serialize::members;
-    } else if constexpr (requires(Type && item) {
-                             requires std::same_as<
-                                 decltype(serialize(item)),
-                                 protocol<decltype(serialize(item))::value,
-                                          decltype(serialize(
-                                              item))::members>>;
-                             requires decltype(serialize(
-                                 item))::members !=
-                                 std::numeric_limits<
+public:
+    using value_type = ByteType;
+
+    segmented_buffer() = default;
+
+    explicit segmented_buffer(chunk_pool<ByteType> & pool) : m_pool(&pool)
+    {
+    }
+
+    segmented_buffer(segmented_buffer && other) noexcept :
+        m_pool(other.m_pool),
+        m_chunks(std::move(other.m_chunks)),
+        m_segments(std::move(other.m_segments)),
+        m_window(std::exchange(other.m_window, nullptr)),
+        m_window_size(std::exchange(other.m_window_size, 0)),
+        m_used(std::exchange(other.m_used, 0)),
+        m_size(std::exchange(other.m_size, 0))
+    {
+        other.m_chunks.clear();
+        other.m_segments.clear();
+    }
+
+    segmented_buffer & operator=(segmented_buffer && other) noexcept
+    {
+        std::swap(m_pool, other.m_pool);
+        std::swap(m_chunks, other.m_chunks);
+        std::swap(m_segments, other.m_segments);
+        std::swap(m_window, other.m_window);
+        std::swap(m_window_size, other.m_window_size);
+        std::swap(m_used, other.m_used);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    ~segmented_buffer()
+    {
+        clear();
+    }
+
+    auto data()
+    {
+        return m_window;
+    }
+
+    std::size_t size() const
+    {
+        return m_window_size;
+    }
+
+    auto & operator[](std::size_t index)
+    {
+        return m_window[index];
+    }
+
+    std::span<const std::span<ByteType>> segments() const
+    {
+        return m_segments;
+    }
+
+    std::size_t total_size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return !m_size;
+    }
+
+    void clear()
+    {
+        for (auto & chunk : m_chunks) {
+            if (m_pool && chunk.size == m_pool->chunk_size()) {
+                m_pool->release(std::move(chunk.data));
+            }
+        }
+        m_chunks.clear();
+        m_segments.clear();
+        m_window = nullptr;
+        m_window_size = 0;
+        m_used = 0;
+        m_size = 0;
+    }
+
+    // The number of bytes before the window.
+    std::size_t offset() const
+    {
+        return m_size - m_used;
+    }
+
+    // The number of window bytes that are already part of segments().
+    std::size_t committed() const
+    {
+        return m_used;
+    }
+
+    void commit(std::size_t position)
+    {
+        if (m_used) {
+            m_segments.pop_back();
+        }
+        if (position) {
+            m_segments.emplace_back(m_window, position);
+        }
+        m_size = m_size - m_used + position;
+        m_used = position;
+    }
+
+    // Commits the window up to position and replaces it with a new chunk
+    // that has room for at least size bytes.
+    void next_segment(std::size_t position, std::size_t size)
+    {
+        commit(position);
+
+        auto chunk_size = m_pool ? m_pool->chunk_size()
+                                 : chunk_pool<ByteType>::default_chunk_size;
+        m_chunks.reserve(m_chunks.size() + 1);
+        if (size > chunk_size) {
+            m_chunks.push_back(
+                {std::make_unique_for_overwrite<ByteType[]>(size), size});
+        } else if (m_pool) {
+            m_chunks.push_back({m_pool->acquire(), chunk_size});
+        } else {
+            m_chunks.push_back(
+                {std::make_unique_for_overwrite<ByteType[]>(chunk_size),
+                 chunk_size});
+        }
+
+        m_window = m_chunks.back().data.get();
+        m_window_size = m_chunks.back().size;
+        m_used = 0;
+    }
+
+    // Commits the window up to position, then stores bytes so that they
+    // follow the first offset bytes of the output. The window is moved past
+    // the stored bytes.
+    void insert(std::size_t position,
+                std::size_t offset,
+                std::span<const ByteType> bytes)
+    {
+        if (bytes.size() > m_window_size - position) {
+            next_segment(position, bytes.size());
+            position = 0;
+        } else {
+            commit(position);
+        }
+
+        auto storage = m_window + position;
+        std::copy(bytes.begin(), bytes.end(), storage);
+        m_window = storage + bytes.size();
+        m_window_size -= position + bytes.size();
+        m_used = 0;
+
+        std::size_t index = 0;
+        while (index < m_segments.size() &&
+               offset >= m_segments[index].size()) {
+            offset -= m_segments[index++].size();
+        }
+        if (offset) {
+            auto segment = m_segments[index];
+            m_segments[index] = segment.first(offset);
+            m_segments.insert(m_segments.begin() + ++index,
+                              segment.subspan(offset));
+        }
+        m_segments.insert(m_segments.begin() + index,
+                          std::span<ByteType>{storage, bytes.size()});
+        m_size += bytes.size();
+    }
+
+private:
+    struct chunk
+    {
+        std::unique_ptr<ByteType[]> data;
+        std::size_t size{};
+    };
+
+    chunk_pool<ByteType> * m_pool{};
+    std::vector<chunk> m_chunks;
+    std::vector<std::span<ByteType>> m_segments;
+    ByteType * m_window{};
+    std::size_t m_window_size{};
+    std::size_t m_used{};
+    std::size_t m_size{};
+};
+
+// A fixed size staging buffer in front of a sink, which is one of a file
+// descriptor, a FILE *, an object with a write(const char *, size) member
+// such as std::ostream, or a callable taking std::span<const ByteType> that
+// returns void or errc. Output archives write into the staging buffer, which
+// is written to the sink whenever it fills up, and when flushed. Large byte
+// payloads are written to the sink directly.
+template <typename Sink, concepts::byte_type ByteType = std::byte>
+class output_stream
+{
+public:
+    using value_type = ByteType;
+
+    constexpr static std::size_t default_capacity = 0x10000;
+
+    explicit output_stream(Sink sink,
+                           std::size_t capacity = default_capacity) :
+        m_sink(std::forward<Sink>(sink)),
+        m_data(std::make_unique_for_overwrite<ByteType[]>(capacity)),
+        m_capacity(capacity)
+    {
+    }
+
+    output_stream(const output_stream &) = delete;
+    output_stream & operator=(const output_stream &) = delete;
+
+    ~output_stream()
+    {
+        static_cast<void>(flush());
+    }
+
+    auto data()
+    {
+        return m_data.get();
+    }
+
+    std::size_t size() const
+    {
+        return m_capacity;
+    }
+
+    auto & operator[](std::size_t index)
+    {
+        return m_data[index];
+    }
+
+    // The number of bytes written so far, including staged bytes.
+    std::size_t total_size() const
+    {
+        return m_written + m_used;
+    }
+
+    // The number of bytes already written to the sink.
+    std::size_t offset() const
+    {
+        return m_written;
+    }
+
+    // The number of staged bytes.
+    std::size_t committed() const
+    {
+        return m_used;
+    }
+
+    void commit(std::size_t position)
+    {
+        m_used = position;
+    }
+
+    errc flush()
+    {
+        return next_segment(m_used, 0);
+    }
+
+    // Writes the staged bytes up to position, making room for at least size
+    // bytes. The staging buffer only grows when size exceeds its capacity.
+    errc next_segment(std::size_t position, std::size_t size)
+    {
+        if (auto result = write_sink({m_data.get(), position});
+            failure(result)) [[unlikely]] {
+            return result;
+        }
+        m_written += position;
+        m_used = 0;
+
+        if (size > m_capacity) {
+            m_data = std::make_unique_for_overwrite<ByteType[]>(size);
+            m_capacity = size;
+        }
+        return {};
+    }
+
+    // Writes the staged bytes up to position, followed by bytes.
+    errc write(std::size_t position, std::span<const std::byte> bytes)
+    {
+        if (auto result = next_segment(position, 0); failure(result))
+            [[unlikely]] {
+            return result;
+        }
+        if (auto result = write_sink(
+                {reinterpret_cast<const ByteType *>(bytes.data()),
+                 bytes.size()});
+            failure(result)) [[unlikely]] {
+            return result;
+        }
+        m_written += bytes.size();
+        return {};
+    }
+
+private:
+    errc write_sink(std::span<const ByteType> bytes)
+    {
+        using sink_type = std::remove_cvref_t<Sink>;
+        if (bytes.empty()) {
+            return {};
+        }
+
+        if constexpr (std::is_invocable_v<Sink &, std::span<const ByteType>>) {
+            if constexpr (std::is_void_v<std::invoke_result_t<
+                              Sink &,
+                              std::span<const ByteType>>>) {
+                m_sink(bytes);
+                return {};
+            } else {
+                return m_sink(bytes);
+            }
+        } else if constexpr (std::same_as<sink_type, std::FILE *>) {
+            if (std::fwrite(bytes.data(), 1, bytes.size(), m_sink) !=
+                bytes.size()) [[unlikely]] {
+                return std::errc::io_error;
+            }
+            return {};
+        } else if constexpr (requires(const char * data) {
+                                 m_sink.write(data, std::ptrdiff_t{});
+                             }) {
+            if (!m_sink.write(reinterpret_cast<const char *>(bytes.data()),
+                              std::ptrdiff_t(bytes.size()))) [[unlikely]] {
+                return std::errc::io_error;
+            }
+            return {};
+#if __has_include(<unistd.h>)
+        } else if constexpr (std::same_as<sink_type, int>) {
+            auto data = bytes.data();
+            auto size = bytes.size();
+            while (size) {
+                auto count = ::write(m_sink, data, size);
+                if (count < 0) [[unlikely]] {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return std::errc(errno);
+                }
+                data += count;
+                size -= std::size_t(count);
+            }
+            return {};
+#endif
+        } else {
+            static_assert(!sizeof(Sink), "Unsupported sink type.");
+        }
+    }
+
+    Sink m_sink;
+    std::unique_ptr<ByteType[]> m_data;
+    std::size_t m_capacity{};
+    std::size_t m_used{};
+    std::size_t m_written{};
+};
+
+template <typename Sink>
+output_stream(Sink &&) -> output_stream<Sink>;
+
+template <typename Sink>
+output_stream(Sink &&, std::size_t) -> output_stream<Sink>;
+
+// A sliding window over a source, which is one of a file descriptor, a
+// FILE *, an object with read(char *, size) and gcount() members such as
+// std::istream, or a callable taking std::span<ByteType> that returns the
+// number of bytes it read, or zero at the end of the input. Input archives
+// read from the window, which is refilled from the source when it runs
+// short. Large byte payloads are read into their destination directly.
+template <typename Source, concepts::byte_type ByteType = std::byte>
+class input_stream
+{
+public:
+    using value_type = ByteType;
+
+    constexpr static std::size_t default_capacity = 0x10000;
+    constexpr static std::size_t default_max_capacity = 0x4000000;
+
+    explicit input_stream(Source source,
+                          std::size_t capacity = default_capacity,
+                          std::size_t max_capacity = default_max_capacity) :
+        m_source(std::forward<Source>(source)),
+        m_data(std::make_unique_for_overwrite<ByteType[]>(capacity)),
+        m_capacity(capacity),
+        m_max_capacity(std::max(capacity, max_capacity))
+    {
+    }
+
+    input_stream(const input_stream &) = delete;
+    input_stream & operator=(const input_stream &) = delete;
+
+    auto data()
+    {
+        return m_data.get();
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    auto & operator[](std::size_t index)
+    {
+        return m_data[index];
+    }
+
+    std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    // The number of bytes consumed before the window.
+    std::size_t offset() const
+    {
+        return m_offset;
+    }
+
+    // The number of consumed window bytes.
+    std::size_t committed() const
+    {
+        return m_used;
+    }
+
+    void commit(std::size_t position)
+    {
+        m_used = position;
+    }
+
+    // Whether all bytes up to the end of the source were consumed.
+    bool exhausted()
+    {
+        if (m_used == m_size) {
+            static_cast<void>(refill(m_used, 1));
+        }
+        return m_used == m_size;
+    }
+
+    // Drops the window bytes before position, and reads from the source
+    // until at least size bytes are available, unless the source ends
+    // first. The window only grows when size exceeds its capacity, and
+    // never beyond the maximum capacity, since sizes are read from the
+    // input and cannot be trusted.
+    errc refill(std::size_t position, std::size_t size)
+    {
+        if (size > m_max_capacity) [[unlikely]] {
+            return std::errc::message_size;
+        }
+        auto remaining = m_size - position;
+        if (size > m_capacity) {
+            auto data = std::make_unique_for_overwrite<ByteType[]>(size);
+            std::memcpy(data.get(), m_data.get() + position, remaining);
+            m_data = std::move(data);
+            m_capacity = size;
+        } else if (remaining && position) {
+            std::memmove(m_data.get(), m_data.get() + position, remaining);
+        }
+        m_offset += position;
+        m_size = remaining;
+        m_used = 0;
+
+        while (m_size < size && !m_end) {
+            auto result =
+                read_source({m_data.get() + m_size, m_capacity - m_size});
+            if (failure(result.error)) [[unlikely]] {
+                return result.error;
+            }
+            m_size += result.count;
+        }
+        return {};
+    }
+
+    // Consumes the window bytes from position, followed by bytes from the
+    // source, into destination.
+    errc read(std::size_t position, std::span<std::byte> destination)
+    {
+        auto target = reinterpret_cast<ByteType *>(destination.data());
+        auto size = destination.size();
+        auto available = std::min(m_size - position, size);
+        std::memcpy(target, m_data.get() + position, available);
+        m_offset += position + available;
+        m_size -= position + available;
+        std::memmove(m_data.get(), m_data.get() + position + available, m_size);
+        m_used = 0;
+        target += available;
+        size -= available;
+
+        while (size) {
+            auto result = read_source({target, size});
+            if (failure(result.error)) [[unlikely]] {
+                return result.error;
+            }
+            if (!result.count) [[unlikely]] {
+                return std::errc::result_out_of_range;
+            }
+            target += result.count;
+            size -= result.count;
+            m_offset += result.count;
+        }
+        return {};
+    }
+
+private:
+    struct read_result
+    {
+        errc error{};
+        std::size_t count{};
+    };
+
+    read_result read_source(std::span<ByteType> bytes)
+    {
+        using source_type = std::remove_cvref_t<Source>;
+        read_result result;
+
+        if constexpr (std::is_invocable_v<Source &, std::span<ByteType>>) {
+            result.count = m_source(bytes);
+        } else if constexpr (std::same_as<source_type, std::FILE *>) {
+            result.count = std::fread(bytes.data(), 1, bytes.size(), m_source);
+            if (result.count < bytes.size() && std::ferror(m_source))
+                [[unlikely]] {
+                result.error = std::errc::io_error;
+            }
+        } else if constexpr (requires(char * data) {
+                                 m_source.read(data, std::ptrdiff_t{});
+                                 m_source.gcount();
+                             }) {
+            m_source.read(reinterpret_cast<char *>(bytes.data()),
+                          std::ptrdiff_t(bytes.size()));
+            result.count = std::size_t(m_source.gcount());
+            if (m_source.bad()) [[unlikely]] {
+                result.error = std::errc::io_error;
+            }
+#if __has_include(<unistd.h>)
+        } else if constexpr (std::same_as<source_type, int>) {
+            while (true) {
+                auto count = ::read(m_source, bytes.data(), bytes.size());
+                if (count < 0) [[unlikely]] {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    result.error = std::errc(errno);
+                } else {
+                    result.count = std::size_t(count);
+                }
+                break;
+            }
+#endif
+        } else {
+            static_assert(!sizeof(Source), "Unsupported source type.");
+        }
+
+        if (!result.count && !failure(result.error)) {
+            m_end = true;
+        }
+        return result;
+    }
+
+    Source m_source;
+    std::unique_ptr<ByteType[]> m_data;
+    std::size_t m_capacity{};
+    std::size_t m_max_capacity{};
+    std::size_t m_size{};
+    std::size_t m_used{};
+    std::size_t m_offset{};
+    bool m_end{};
+};
+
+template <typename Source>
+input_stream(Source &&) -> input_stream<Source>;
+
+template <typename Source>
+input_stream(Source &&, std::size_t) -> input_stream<Source>;
+
+template <typename Source>
+input_stream(Source &&, std::size_t, std::size_t) -> input_stream<Source>;
+
+template <typename Option>
+struct option
+{
+    using zpp_bits_option = void;
+    constexpr auto operator()(auto && archive)
+    {
+        if constexpr (requires {
+                          archive.option(static_cast<Option &>(*this));
+                      }) {
+            archive.option(static_cast<Option &>(*this));
+        }
+    }
+};
+
+inline namespace options
+{
+struct append : option<append>
+{
+};
+
+struct reserve : option<reserve>
+{
+    constexpr explicit reserve(std::size_t size) : size(size)
+    {
+    }
+    std::size_t size{};
+};
+
+struct resize : option<resize>
+{
+    constexpr explicit resize(std::size_t size) : size(size)
+    {
+    }
+    std::size_t size{};
+};
+
+template <std::size_t Size>
+struct alloc_limit : option<alloc_limit<Size>>
+{
+    constexpr static auto alloc_limit_value = Size;
+};
+
+template <std::size_t Multiplier, std::size_t Divisor = 1>
+struct enlarger : option<enlarger<Multiplier, Divisor>>
+{
+    constexpr static auto enlarger_value =
+        std::tuple{Multiplier, Divisor};
+};
+
+using exact_enlarger = enlarger<1, 1>;
+
+namespace endian
+{
+struct big : option<big>
+{
+    constexpr static auto value = std::endian::big;
+};
+
+struct little : option<little>
+{
+    constexpr static auto value = std::endian::little;
+};
+
+using network = big;
+
+using native = std::
+    conditional_t<std::endian::native == std::endian::little, little, big>;
+
+using swapped = std::
+    conditional_t<std::endian::native == std::endian::little, big, little>;
+} // namespace endian
+
+struct no_fit_size : option<no_fit_size>
+{
+};
+
+// Pads sized arrays of byte serializable elements to the element alignment,
+// so that input views of them can alias the input.
+struct align_arrays : option<align_arrays>
+{
+};
+
+// Input views of byte serializable elements that are misaligned in the
+// input are copied into the given storage and refer to it, instead of
+// failing. The storage is used in order, so views decoded by the same
+// archive do not overlap.
+struct copy_misaligned : option<copy_misaligned>
+{
+    constexpr explicit copy_misaligned(auto && storage) requires requires {
+        std::as_writable_bytes(std::span{storage});
+    } : storage(std::as_writable_bytes(std::span{storage}))
+    {
+    }
+    std::span<std::byte> storage;
+};
+
+// Input decodes into the objects already held by pointers, optionals and
+// associative containers, instead of allocating new ones, so that decoding
+// repeatedly into the same object does not allocate once warmed up.
+struct reuse : option<reuse>
+{
+};
+
+struct no_enlarge_overflow : option<no_enlarge_overflow>
+{
+};
+
+struct enlarge_overflow : option<enlarge_overflow>
+{
+};
+
+struct no_size : option<no_size>
+{
+    using default_size_type = void;
+};
+
+struct size1b : option<size1b>
+{
+    using default_size_type = unsigned char;
+};
+
+struct size2b : option<size2b>
+{
+    using default_size_type = std::uint16_t;
+};
+
+struct size4b : option<size4b>
+{
+    using default_size_type = std::uint32_t;
+};
+
+struct size8b : option<size8b>
+{
+    using default_size_type = std::uint64_t;
+};
+
+struct size_native : option<size_native>
+{
+    using default_size_type = std::size_t;
+};
+
+template <typename Protocol>
+struct protocol_option : option<protocol_option<Protocol>> {
+    using protocol_type = Protocol;
+};
+} // namespace options
+
+namespace concepts {
+    template <typename Option>
+    concept is_protocol_option = requires {
+        requires std::same_as<std::remove_cvref_t<Option>, protocol_option<typename Option::protocol_type>>;
+    };
+}
+
+struct any
+{
+    template <typename Type>
+    operator Type() 
+#if ZPP_BITS_AUTODETECT_MEMBERS_MODE == 0
+    requires (! concepts::optional<Type>)
+#endif
+    ;
+};
+
+template <typename Type>
+constexpr auto access::number_of_members()
+{
+    using type = std::remove_cvref_t<Type>;
+    if constexpr (std::is_array_v<type>) {
+        return std::extent_v<type>;
+    } else if constexpr (!std::is_class_v<type>) {
+        return 0;
+    } else if constexpr (concepts::container<type> && requires {
+                             std::integral_constant<
+                                 std::size_t,
+                                 type{}.size()>::value != 0;
+                         }) {
+        return type{}.size();
+    } else if constexpr (concepts::tuple<type>) {
+        return std::tuple_size_v<type>;
+    } else if constexpr (requires {
+                             requires std::same_as<
+                                 typename type::serialize,
+                                 members<type::serialize::value>>;
+                             requires type::serialize::value !=
+                                 std::numeric_limits<
+                                     std::size_t>::max();
+                         }) {
+        return type::serialize::value;
+    } else if constexpr (requires(Type && item) {
+                             requires std::same_as<
+                                 decltype(serialize(item)),
+                                 members<decltype(serialize(
+                                     item))::value>>;
+                             requires decltype(serialize(
+                                 item))::value !=
+                                 std::numeric_limits<
+                                     std::size_t>::max();
+                         }) {
+        return decltype(serialize(std::declval<type>()))::value;
+    } else if constexpr (requires {
+                             requires std::same_as<
+                                 typename type::serialize,
+                                 protocol<type::serialize::value,
+                                          type::serialize::members>>;
+                             requires type::serialize::members !=
+                                 std::numeric_limits<
+                                     std::size_t>::max();
+                         }) {
+        return type::serialize::members;
+    } else if constexpr (requires(Type && item) {
+                             requires std::same_as<
+                                 decltype(serialize(item)),
+                                 protocol<decltype(serialize(item))::value,
+                                          decltype(serialize(
+                                              item))::members>>;
+                             requires decltype(serialize(
+                                 item))::members !=
+                                 std::numeric_limits<
                                      std::size_t>::max();
                          }) {
         return decltype(serialize(std::declval<type>()))::members;
@@ -1419,6 +2296,34 @@ constexpr decltype(auto) ZPP_BITS_INLINE visit_members(auto && object,
     return access::visit_members(object, visitor);
 }
 
+namespace traits
+{
+template <typename Type>
+struct external_object_wrapper
+{
+    Type value;
+};
+
+// Never defined, only its member addresses are compared at compile time.
+template <typename Type>
+extern const external_object_wrapper<Type> external_object;
+
+// Which members of Type, in order, are pointed to by Members.
+template <typename Type, auto... Members>
+constexpr auto member_mask()
+{
+    return visit_members(external_object<Type>.value, [](auto &... members) {
+        auto selected = [](auto & member) {
+            return (false || ... ||
+                    (static_cast<const void *>(std::addressof(
+                         external_object<Type>.value.*Members)) ==
+                     static_cast<const void *>(std::addressof(member))));
+        };
+        return std::array<bool, sizeof...(members)>{selected(members)...};
+    });
+}
+} // namespace traits
+
 template <typename Type>
 constexpr decltype(auto) visit_members_types(auto && visitor)
 {
@@ -1550,6 +2455,8 @@ enum class varint_encoding
 {
     normal,
     zig_zag,
+    prefix,
+    group,
 };
 
 template <typename Type, varint_encoding Encoding = varint_encoding::normal>
@@ -1601,9 +2508,38 @@ concept varint = requires
 
 } // namespace concepts
 
+template <typename Type, varint_encoding Encoding = varint_encoding::normal>
+constexpr auto varint_max_size =
+    Encoding == varint_encoding::group
+        ? sizeof(Type) + 1
+        : Encoding == varint_encoding::prefix
+            ? std::min(sizeof(Type) * CHAR_BIT / (CHAR_BIT - 1) + 1,
+                       sizeof(std::uint64_t) + 1)
+            : sizeof(Type) * CHAR_BIT / (CHAR_BIT - 1) + 1;
+
+// The two bit length code of a group varint, for lengths of one to four
+// bytes, or of one, two, four and eight bytes for types wider than 32 bits.
+template <typename Type>
+constexpr unsigned ZPP_BITS_INLINE varint_group_code(Type value)
+{
+    auto bits = std::bit_width(
+        std::uint64_t(std::make_unsigned_t<Type>(value)) | 0x1);
+    if constexpr (sizeof(Type) > sizeof(std::uint32_t)) {
+        return unsigned(bits > 8) + unsigned(bits > 16) + unsigned(bits > 32);
+    } else {
+        return unsigned(bits > 8) + unsigned(bits > 16) + unsigned(bits > 24);
+    }
+}
+
 template <typename Type>
-constexpr auto varint_max_size = sizeof(Type) * CHAR_BIT / (CHAR_BIT - 1) +
-                                 1;
+constexpr std::size_t ZPP_BITS_INLINE varint_group_length(unsigned code)
+{
+    if constexpr (sizeof(Type) > sizeof(std::uint32_t)) {
+        return std::size_t{1} << code;
+    } else {
+        return code + 1;
+    }
+}
 
 template <varint_encoding Encoding = varint_encoding::normal>
 constexpr auto ZPP_BITS_INLINE varint_size(auto value)
@@ -1611,6 +2547,12 @@ constexpr auto ZPP_BITS_INLINE varint_size(auto value)
     if constexpr (Encoding == varint_encoding::zig_zag) {
         return varint_size(std::make_unsigned_t<decltype(value)>((value << 1) ^
                            (value >> (sizeof(value) * CHAR_BIT - 1))));
+    } else if constexpr (Encoding == varint_encoding::prefix) {
+        return std::min(varint_size(value), sizeof(std::uint64_t) + 1);
+    } else if constexpr (Encoding == varint_encoding::group) {
+        return varint_group_length<decltype(value)>(
+                   varint_group_code(value)) +
+               1;
     } else {
         return ((sizeof(value) * CHAR_BIT) -
                 std::countl_zero(
@@ -1620,6 +2562,391 @@ constexpr auto ZPP_BITS_INLINE varint_size(auto value)
     }
 }
 
+namespace traits
+{
+template <typename Item>
+struct varint_item
+{
+    using type = Item;
+    static constexpr auto encoding = varint_encoding::normal;
+};
+
+template <typename Type, varint_encoding Encoding>
+struct varint_item<varint<Type, Encoding>>
+{
+    using type = Type;
+    static constexpr auto encoding = Encoding;
+};
+
+// Whether Item is a group varint, which containers encode four at a time.
+template <typename Item>
+constexpr bool group_varint =
+    concepts::varint<Item> &&
+    varint_item<Item>::encoding == varint_encoding::group;
+} // namespace traits
+
+// Views integers, enumerations or varints, serialized as consecutive
+// varints without a size, encoded and decoded in bulk.
+template <typename Item,
+          varint_encoding Encoding =
+              traits::varint_item<std::remove_cv_t<Item>>::encoding>
+class varint_span
+{
+public:
+    using value_type = Item;
+    using integer_type =
+        typename traits::varint_item<std::remove_cv_t<Item>>::type;
+    using unsigned_type =
+        std::make_unsigned_t<traits::underlying_type_t<integer_type>>;
+    static constexpr auto encoding = Encoding;
+
+    constexpr explicit varint_span(std::span<Item> items) : m_items(items)
+    {
+    }
+
+    constexpr auto data() const
+    {
+        return m_items.data();
+    }
+
+    constexpr std::size_t count() const
+    {
+        return m_items.size();
+    }
+
+    // The varint value of an item, before the seven bit encoding.
+    static constexpr unsigned_type ZPP_BITS_INLINE
+    to_unsigned(const Item & item)
+    {
+        auto value = traits::underlying_type_t<integer_type>(
+            integer_type(item));
+        if constexpr (Encoding == varint_encoding::zig_zag) {
+            return unsigned_type(
+                (unsigned_type(value) << 1) ^
+                unsigned_type(value >> (sizeof(value) * CHAR_BIT - 1)));
+        } else {
+            return unsigned_type(value);
+        }
+    }
+
+    static constexpr void ZPP_BITS_INLINE from_unsigned(Item & item,
+                                                        unsigned_type value)
+    {
+        if constexpr (Encoding == varint_encoding::zig_zag) {
+            item = Item(integer_type(
+                traits::underlying_type_t<integer_type>(
+                    (value >> 1) ^ -(value & 0x1))));
+        } else {
+            item = Item(integer_type(value));
+        }
+    }
+
+private:
+    std::span<Item> m_items;
+};
+
+template <typename Item>
+varint_span(std::span<Item>) -> varint_span<Item>;
+
+template <typename Item, std::size_t Count>
+varint_span(Item (&)[Count]) -> varint_span<Item>;
+
+template <concepts::container Container>
+varint_span(Container && container)
+    -> varint_span<std::remove_reference_t<decltype(container[0])>>;
+
+namespace kernels
+{
+// Encodes a varint of at most MaxSize bytes on a little endian target,
+// returning its size. The seven bit groups are spread to bytes, the
+// continuation bits are added by size, and the encoding is written with
+// one word store, or two when MaxSize exceeds a word, for which there
+// must be room.
+template <std::size_t MaxSize>
+inline std::size_t encode_varint_words(std::uint64_t value, void * data)
+{
+    static_assert(std::endian::native == std::endian::little);
+
+    auto size = varint_size(value);
+    auto word = value & 0x00ffffffffffffff;
+    word = ((word & 0x00fffffff0000000) << 4) | (word & 0x0fffffff);
+    word = ((word & 0x0fffc0000fffc000) << 2) | (word & 0x00003fff00003fff);
+    word = ((word & 0x3f803f803f803f80) << 1) | (word & 0x007f007f007f007f);
+    if constexpr (MaxSize > sizeof(std::uint64_t)) {
+        if (size > sizeof(std::uint64_t)) [[unlikely]] {
+            auto high = value >> 56;
+            std::uint64_t words[] = {word | 0x8080808080808080,
+                                     (high & 0x7f) | ((high >> 7) * 0x180)};
+            std::memcpy(data, words, sizeof(words));
+            return size;
+        }
+    }
+    word |= 0x8080808080808080 &
+            ((std::uint64_t{1} << (CHAR_BIT * (size - 1))) - 1);
+    std::memcpy(data, &word, sizeof(word));
+    return size;
+}
+
+// Gathers the seven bit groups of a varint that ends within a little
+// endian word, the reverse of the spreading in encode_varint_words().
+constexpr std::uint64_t compact_varint_word(std::uint64_t word)
+{
+    word &= 0x7f7f7f7f7f7f7f7f;
+    word = ((word & 0x7f007f007f007f00) >> 1) | (word & 0x007f007f007f007f);
+    word = ((word & 0x3fff00003fff0000) >> 2) | (word & 0x00003fff00003fff);
+    return ((word & 0x0fffffff00000000) >> 4) | (word & 0x0fffffff);
+}
+
+// Counts the varints that end within the data, which is the number of
+// bytes without a continuation bit.
+inline std::size_t count_varints(const std::byte * data, std::size_t size)
+{
+    std::size_t count = size;
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        count -= std::popcount(word & 0x8080808080808080);
+    }
+    for (; i < size; ++i) {
+        count -= std::size_t(data[i] >> 7);
+    }
+    return count;
+}
+
+#if ZPP_BITS_X86_KERNELS
+// Whether pext is available and fast, which it is not on Zen and Zen 2
+// where it is implemented in microcode.
+inline bool fast_pext()
+{
+#if defined __BMI2__
+    return true;
+#else
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("bmi2") &&
+               !__builtin_cpu_is("znver1") && !__builtin_cpu_is("znver2");
+    }();
+    return supported;
+#endif
+}
+
+// Decodes a 64 bit varint from at least ten bytes of data, returning its
+// size, or zero if it does not end within ten bytes. The first eight bytes
+// are loaded at once, their stop bits locate the end, and pext gathers the
+// seven bit groups.
+[[gnu::target("bmi2")]] inline std::size_t
+decode_varint_bmi2(const std::byte * data, std::uint64_t & value)
+{
+    constexpr auto groups = std::uint64_t{0x7f7f7f7f7f7f7f7f};
+
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    if (auto stops = ~word & ~groups) [[likely]] {
+        auto last = stops & (~stops + 1);
+        value = _pext_u64(word & (last ^ (last - 1)), groups);
+        return std::size_t(std::countr_zero(stops) + 1) / CHAR_BIT;
+    }
+
+    value = _pext_u64(word, groups);
+    auto next_byte = std::uint64_t(data[8]);
+    value |= (next_byte & 0x7f) << ((CHAR_BIT - 1) * 8);
+    if (next_byte < 0x80) {
+        return 9;
+    }
+    next_byte = std::uint64_t(data[9]);
+    value |= (next_byte & 0x01) << ((CHAR_BIT - 1) * 9);
+    if (next_byte < 0x80) {
+        return 10;
+    }
+    return 0;
+}
+#endif
+} // namespace kernels
+
+// Stores the low size bytes of the value in little endian order, as a whole
+// word when there is room for one. Room is the number of bytes that may be
+// written, which callers bound by what was written past the position.
+constexpr void ZPP_BITS_INLINE store_varint_bytes(std::uint64_t value,
+                                                  std::size_t size,
+                                                  auto * data,
+                                                  std::size_t room)
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        if (!std::is_constant_evaluated() && room >= sizeof(value)) {
+            std::memcpy(data, &value, sizeof(value));
+            return;
+        }
+    }
+    using byte_type = std::remove_cvref_t<decltype(*data)>;
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = byte_type(value >> (CHAR_BIT * i));
+    }
+}
+
+constexpr std::uint64_t ZPP_BITS_INLINE load_varint_bytes(const auto * data,
+                                                          std::size_t size,
+                                                          std::size_t room)
+{
+    std::uint64_t value{};
+    if constexpr (std::endian::native == std::endian::little) {
+        if (!std::is_constant_evaluated() && room >= sizeof(value)) {
+            std::memcpy(&value, data, sizeof(value));
+            if (size < sizeof(value)) {
+                value &= (std::uint64_t{1} << (CHAR_BIT * size)) - 1;
+            }
+            return value;
+        }
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        value |= std::uint64_t(std::uint8_t(data[i])) << (CHAR_BIT * i);
+    }
+    return value;
+}
+
+// A prefix varint of up to eight bytes holds its size in the trailing zero
+// bits of the first byte, followed by the value, little endian. A zero
+// first byte is followed by eight bytes of value.
+constexpr void ZPP_BITS_INLINE encode_prefix_varint(std::uint64_t value,
+                                                    std::size_t size,
+                                                    auto * data,
+                                                    std::size_t room)
+{
+    using byte_type = std::remove_cvref_t<decltype(*data)>;
+    if (size > sizeof(value)) [[unlikely]] {
+        data[0] = byte_type{};
+        store_varint_bytes(value, sizeof(value), data + 1, room - 1);
+        return;
+    }
+    store_varint_bytes(
+        (value << size) | (std::uint64_t{1} << (size - 1)), size, data, room);
+}
+
+constexpr errc ZPP_BITS_INLINE decode_prefix_varint(auto data,
+                                                    auto & value,
+                                                    auto & position)
+{
+    using value_type = std::remove_cvref_t<decltype(value)>;
+    if (data.empty()) [[unlikely]] {
+        return errc{std::errc::result_out_of_range};
+    }
+    auto first = std::uint8_t(data[0]);
+    auto size = first ? std::size_t(std::countr_zero(first)) + 1
+                      : sizeof(std::uint64_t) + 1;
+    if (size > varint_max_size<value_type, varint_encoding::prefix>)
+        [[unlikely]] {
+        return errc{std::errc::value_too_large};
+    }
+    if (size > data.size()) [[unlikely]] {
+        return errc{std::errc::result_out_of_range};
+    }
+    if (first) [[likely]] {
+        value = value_type(load_varint_bytes(data.data(), size, data.size()) >>
+                           size);
+    } else {
+        value = value_type(load_varint_bytes(
+            data.data() + 1, sizeof(std::uint64_t), data.size() - 1));
+    }
+    position += size;
+    return errc{};
+}
+
+// Group varints share a control byte between up to four values, holding the
+// length code of each value in two bits from the low bits up, followed by
+// the values in as many little endian bytes. Returns the encoded size.
+template <typename Type>
+constexpr std::size_t ZPP_BITS_INLINE encode_group_varints(
+    auto && value_at, std::size_t count, auto * data, std::size_t room)
+{
+    using byte_type = std::remove_cvref_t<decltype(*data)>;
+    unsigned control = 0;
+    std::size_t position = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        Type value = value_at(i);
+        auto code = varint_group_code(value);
+        auto length = varint_group_length<Type>(code);
+        control |= code << (2 * i);
+        store_varint_bytes(value, length, data + position, room - position);
+        position += length;
+    }
+    data[0] = byte_type(control);
+    return position;
+}
+
+template <typename Type>
+constexpr errc ZPP_BITS_INLINE decode_group_varints(auto data,
+                                                    std::size_t count,
+                                                    auto && store_at,
+                                                    auto & position)
+{
+    if (data.empty()) [[unlikely]] {
+        return errc{std::errc::result_out_of_range};
+    }
+    auto control = unsigned(std::uint8_t(data[0]));
+    std::size_t offset = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto length = varint_group_length<Type>((control >> (2 * i)) & 0x3);
+        if constexpr (sizeof(Type) < sizeof(std::uint32_t)) {
+            if (length > sizeof(Type)) [[unlikely]] {
+                return errc{std::errc::value_too_large};
+            }
+        }
+        if (length > data.size() - offset) [[unlikely]] {
+            return errc{std::errc::result_out_of_range};
+        }
+        store_at(i,
+                 Type(load_varint_bytes(
+                     data.data() + offset, length, data.size() - offset)));
+        offset += length;
+    }
+    position += offset;
+    return errc{};
+}
+
+// Encodes an unsigned varint value in exactly varint_max_size bytes, which
+// decodes as the shortest encoding does, so that its size is known before
+// the value is.
+template <typename Type, varint_encoding Encoding>
+constexpr void ZPP_BITS_INLINE encode_varint_max_size(std::uint64_t value,
+                                                      auto * data)
+{
+    using byte_type = std::remove_cvref_t<decltype(*data)>;
+    constexpr auto size = varint_max_size<Type, Encoding>;
+    if constexpr (varint_encoding::prefix == Encoding) {
+        encode_prefix_varint(value, size, data, size);
+    } else if constexpr (varint_encoding::group == Encoding) {
+        constexpr unsigned code =
+            sizeof(Type) > sizeof(std::uint32_t) ? 3 : sizeof(Type) - 1;
+        data[0] = byte_type(code);
+        store_varint_bytes(value, sizeof(Type), data + 1, sizeof(Type));
+    } else {
+        if constexpr (varint_encoding::zig_zag == Encoding) {
+            value <<= 1;
+        }
+        for (std::size_t i = 0; i < size - 1; ++i) {
+            data[i] = byte_type((value & 0x7f) | 0x80);
+            value >>= (CHAR_BIT - 1);
+        }
+        data[size - 1] = byte_type(value);
+    }
+}
+
+// The bytes from the position that word stores of an encoding of size
+// bytes may write, which are past the encoding only where nothing was
+// written past the position yet.
+template <typename Archive>
+constexpr std::size_t ZPP_BITS_INLINE varint_store_room(Archive & archive,
+                                                        std::size_t room,
+                                                        std::size_t size)
+{
+    if constexpr (Archive::resizable) {
+        if (archive.position() >= archive.written()) {
+            return room;
+        }
+    }
+    return size;
+}
+
 template <typename Archive, typename Type, varint_encoding Encoding>
 constexpr auto ZPP_BITS_INLINE serialize(
     Archive & archive,
@@ -1634,7 +2961,15 @@ constexpr auto ZPP_BITS_INLINE serialize(
             (value << 1) ^ (orig_value >> (sizeof(Type) * CHAR_BIT - 1));
     }
 
-    constexpr auto max_size = varint_max_size<Type>;
+    constexpr auto size_encoding = varint_encoding::zig_zag == Encoding
+                                       ? varint_encoding::normal
+                                       : Encoding;
+    if constexpr (requires { requires Archive::measuring; }) {
+        archive.position() += varint_size<size_encoding>(value);
+        return errc{};
+    }
+
+    constexpr auto max_size = varint_max_size<Type, Encoding>;
     if constexpr (Archive::resizable) {
         if (auto result = archive.enlarge_for(max_size); failure(result))
             [[unlikely]] {
@@ -1646,12 +2981,47 @@ constexpr auto ZPP_BITS_INLINE serialize(
     if constexpr (!Archive::resizable) {
         auto data_size = data.size();
         if (data_size < max_size) [[unlikely]] {
-            if (data_size < varint_size(value)) [[unlikely]] {
+            if (data_size < varint_size<size_encoding>(value)) [[unlikely]] {
                 return errc{std::errc::result_out_of_range};
             }
         }
     }
 
+    if constexpr (varint_encoding::prefix == Encoding) {
+        auto size = varint_size<Encoding>(value);
+        encode_prefix_varint(value,
+                             size,
+                             data.data(),
+                             varint_store_room(archive, data.size(), size));
+        archive.position() += size;
+        return errc{};
+    } else if constexpr (varint_encoding::group == Encoding) {
+        archive.position() += encode_group_varints<decltype(value)>(
+            [value](auto) { return value; },
+            1,
+            data.data(),
+            varint_store_room(
+                archive, data.size(), varint_size<Encoding>(value)));
+        return errc{};
+    }
+
+    // Word stores write past the end of the varint, so they are only used
+    // where nothing was written past the position yet.
+    if constexpr (Archive::resizable &&
+                  std::endian::native == std::endian::little &&
+                  sizeof(value) <= sizeof(std::uint64_t)) {
+        constexpr auto store_size =
+            max_size > sizeof(std::uint64_t) ? 2 * sizeof(std::uint64_t)
+                                             : sizeof(std::uint64_t);
+        if (!std::is_constant_evaluated() &&
+            archive.position() >= archive.written() &&
+            data.size() >= store_size) {
+            archive.position() +=
+                kernels::encode_varint_words<max_size>(value, data.data());
+            return errc{};
+        }
+    }
+
     using byte_type = std::remove_cvref_t<decltype(data[0])>;
     std::size_t position = {};
     while (value >= 0x80) {
@@ -1667,6 +3037,23 @@ constexpr auto ZPP_BITS_INLINE serialize(
 constexpr auto decode_varint(auto data, auto & value, auto & position)
 {
     using value_type = std::remove_cvref_t<decltype(value)>;
+#if ZPP_BITS_X86_KERNELS
+    if constexpr (sizeof(value_type) == sizeof(std::uint64_t)) {
+        if (!std::is_constant_evaluated() &&
+            data.size() >= varint_max_size<value_type> &&
+            kernels::fast_pext()) {
+            std::uint64_t decoded{};
+            auto size = kernels::decode_varint_bmi2(
+                reinterpret_cast<const std::byte *>(data.data()), decoded);
+            if (!size) [[unlikely]] {
+                return errc{std::errc::value_too_large};
+            }
+            value = value_type(decoded);
+            position += size;
+            return errc{};
+        }
+    }
+#endif
     if (data.size() < varint_max_size<value_type>) [[unlikely]] {
         std::size_t shift = 0;
         for (auto & byte_value : data) {
@@ -1715,14 +3102,44 @@ constexpr auto ZPP_BITS_INLINE serialize(
         std::is_enum_v<Type>,
         std::make_unsigned_t<traits::underlying_type_t<Type>>,
         std::make_unsigned_t<Type>>;
+    constexpr auto max_size = varint_max_size<value_type, Encoding>;
     value_type value{};
+    if constexpr (requires { requires Archive::streaming; }) {
+        if (archive.remaining_data().size() < max_size) [[unlikely]] {
+            if (auto result = archive.refill(max_size); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+        }
+    }
     auto data = archive.remaining_data();
 
-    if constexpr (!ZPP_BITS_INLINE_DECODE_VARINT) {
+    if constexpr (varint_encoding::prefix == Encoding ||
+                  varint_encoding::group == Encoding) {
+        auto result =
+            varint_encoding::prefix == Encoding
+                ? decode_prefix_varint(data, value, archive.position())
+                : decode_group_varints<value_type>(
+                      data,
+                      1,
+                      [&value](auto, auto item) { value = item; },
+                      archive.position());
+        if (failure(result)) [[unlikely]] {
+            return result;
+        }
+        self.value = decltype(self.value)(value);
+        return errc{};
+    } else if constexpr (!ZPP_BITS_INLINE_DECODE_VARINT) {
         auto & position = archive.position();
+        // One and two byte varints are decoded inline, the word kernels
+        // only pay off for longer ones.
         if (!data.empty() && !(value_type(data[0]) & 0x80)) [[likely]] {
             value = value_type(data[0]);
             position += 1;
+        } else if (data.size() >= 2 && !(value_type(data[1]) & 0x80)) {
+            value = value_type((value_type(data[0]) & 0x7f) |
+                               (value_type(data[1]) << (CHAR_BIT - 1)));
+            position += 2;
         } else if (auto result =
                        std::is_constant_evaluated()
                            ? decode_varint(data, value, position)
@@ -1791,16 +3208,303 @@ constexpr auto ZPP_BITS_INLINE serialize(
         } else {
             self.value = decltype(self.value)(value);
         }
-        archive.position() += std::distance(data.data(), p);
-        return errc{};
+        archive.position() += std::distance(data.data(), p);
+        return errc{};
+    }
+}
+
+template <typename Archive, typename Type, varint_encoding Encoding>
+constexpr auto
+serialize(Archive & archive,
+          varint<Type, Encoding> && self) requires(Archive::kind() ==
+                                                   kind::in) = delete;
+
+// Writes prefix varints one by one, or group varints in groups of four,
+// whose encoding takes size bytes.
+template <typename Archive, typename Item, varint_encoding Encoding>
+constexpr errc serialize_varint_groups(Archive & archive,
+                                       varint_span<Item, Encoding> items,
+                                       std::size_t size)
+{
+    using span_type = varint_span<Item, Encoding>;
+    using unsigned_type = typename span_type::unsigned_type;
+
+    if constexpr (Archive::resizable) {
+        if (auto result = archive.enlarge_for(size); failure(result))
+            [[unlikely]] {
+            return result;
+        }
+    }
+
+    auto data = archive.remaining_data();
+    if constexpr (!Archive::resizable) {
+        if (data.size() < size) [[unlikely]] {
+            return errc{std::errc::result_out_of_range};
+        }
+    }
+
+    auto values = items.data();
+    auto count = items.count();
+    auto room = varint_store_room(archive, data.size(), size);
+    std::size_t position = {};
+    if constexpr (varint_encoding::prefix == Encoding) {
+        for (std::size_t i = 0; i < count; ++i) {
+            auto value = span_type::to_unsigned(values[i]);
+            auto value_size = varint_size<Encoding>(value);
+            encode_prefix_varint(value,
+                                 value_size,
+                                 data.data() + position,
+                                 room - position);
+            position += value_size;
+        }
+    } else {
+        // Whole groups are encoded with a constant count, which unrolls.
+        std::size_t i = 0;
+        auto encode_group = [&](std::size_t group_count) {
+            position += encode_group_varints<unsigned_type>(
+                [&](auto j) { return span_type::to_unsigned(values[i + j]); },
+                group_count,
+                data.data() + position,
+                room - position);
+        };
+        for (; count - i >= 4; i += 4) {
+            encode_group(4);
+        }
+        if (i < count) {
+            encode_group(count - i);
+        }
+    }
+
+    archive.position() += size;
+    return errc{};
+}
+
+// Writes the items as consecutive varints, whose encoding takes size
+// bytes.
+template <typename Archive, typename Item, varint_encoding Encoding>
+constexpr errc serialize_varints(Archive & archive,
+                                 varint_span<Item, Encoding> items,
+                                 std::size_t size)
+{
+    using span_type = varint_span<Item, Encoding>;
+    using unsigned_type = typename span_type::unsigned_type;
+    constexpr auto max_size = varint_max_size<unsigned_type>;
+
+    if constexpr (requires { requires Archive::measuring; }) {
+        archive.position() += size;
+        return errc{};
+    }
+
+    if constexpr (varint_encoding::prefix == Encoding ||
+                  varint_encoding::group == Encoding) {
+        return serialize_varint_groups(archive, items, size);
+    }
+
+    if (std::is_constant_evaluated()) {
+        for (auto & item : std::span{items.data(), items.count()}) {
+            if (auto result = archive(varint<unsigned_type>{
+                    span_type::to_unsigned(item)});
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+        }
+        return errc{};
+    }
+
+    if constexpr (Archive::resizable) {
+        if (auto result = archive.enlarge_for(size); failure(result))
+            [[unlikely]] {
+            return result;
+        }
+    }
+
+    auto data = archive.remaining_data();
+    if constexpr (!Archive::resizable) {
+        if (data.size() < size) [[unlikely]] {
+            return errc{std::errc::result_out_of_range};
+        }
+    }
+
+    auto out = reinterpret_cast<std::byte *>(data.data());
+    auto end = out + varint_store_room(archive, data.size(), size);
+    for (auto & item : std::span{items.data(), items.count()}) {
+        auto value = span_type::to_unsigned(item);
+        if constexpr (std::endian::native == std::endian::little &&
+                      sizeof(unsigned_type) <= sizeof(std::uint64_t)) {
+            if (end - out >= std::ptrdiff_t(2 * sizeof(std::uint64_t)))
+                [[likely]] {
+                out += kernels::encode_varint_words<max_size>(value, out);
+                continue;
+            }
+        }
+        while (value >= 0x80) {
+            *out++ = std::byte((value & 0x7f) | 0x80);
+            value >>= (CHAR_BIT - 1);
+        }
+        *out++ = std::byte(value);
+    }
+
+    archive.position() += size;
+    return errc{};
+}
+
+template <typename Archive, typename Item, varint_encoding Encoding>
+constexpr errc ZPP_BITS_INLINE
+serialize(Archive & archive,
+          varint_span<Item, Encoding> self) requires(Archive::kind() ==
+                                                     kind::out)
+{
+    std::size_t size = {};
+    if constexpr (varint_encoding::group == Encoding) {
+        size = (self.count() + 3) / 4;
+        for (auto & item : std::span{self.data(), self.count()}) {
+            size += varint_size<Encoding>(self.to_unsigned(item)) - 1;
+        }
+    } else {
+        constexpr auto size_encoding = varint_encoding::prefix == Encoding
+                                           ? Encoding
+                                           : varint_encoding::normal;
+        for (auto & item : std::span{self.data(), self.count()}) {
+            size += varint_size<size_encoding>(self.to_unsigned(item));
+        }
     }
+    return serialize_varints(archive, self, size);
 }
 
-template <typename Archive, typename Type, varint_encoding Encoding>
-constexpr auto
+template <typename Archive, typename Item, varint_encoding Encoding>
+constexpr errc ZPP_BITS_INLINE
 serialize(Archive & archive,
-          varint<Type, Encoding> && self) requires(Archive::kind() ==
-                                                   kind::in) = delete;
+          varint_span<Item, Encoding> self) requires(Archive::kind() ==
+                                                     kind::in)
+{
+    using span_type = varint_span<Item, Encoding>;
+    using unsigned_type = typename span_type::unsigned_type;
+    auto items = self.data();
+    auto count = self.count();
+
+    if constexpr (varint_encoding::prefix == Encoding) {
+        for (std::size_t i = 0; i < count; ++i) {
+            varint<unsigned_type, Encoding> value;
+            if (auto result = archive(value); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+            span_type::from_unsigned(items[i], value);
+        }
+        return errc{};
+    } else if constexpr (varint_encoding::group == Encoding) {
+        constexpr auto group_size = 1 + 4 * sizeof(unsigned_type);
+        for (std::size_t i = 0; i < count; i += 4) {
+            if constexpr (requires { requires Archive::streaming; }) {
+                if (archive.remaining_data().size() < group_size)
+                    [[unlikely]] {
+                    if (auto result = archive.refill(group_size);
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+                }
+            }
+            if (auto result = decode_group_varints<unsigned_type>(
+                    archive.remaining_data(),
+                    std::min(count - i, std::size_t{4}),
+                    [&](auto j, auto value) {
+                        span_type::from_unsigned(items[i + j], value);
+                    },
+                    archive.position());
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+        }
+        return errc{};
+    }
+
+    if (std::is_constant_evaluated() ||
+        requires { requires Archive::streaming; }) {
+        for (std::size_t i = 0; i < count; ++i) {
+            varint<unsigned_type> value;
+            if (auto result = archive(value); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+            span_type::from_unsigned(items[i], value);
+        }
+        return errc{};
+    }
+
+    auto remaining = archive.remaining_data();
+    std::span data{reinterpret_cast<const std::byte *>(remaining.data()),
+                   remaining.size()};
+    std::size_t position = {};
+    std::size_t i = 0;
+    while (i < count) {
+        if constexpr (std::endian::native == std::endian::little) {
+            if (data.size() - position >= sizeof(std::uint64_t)) [[likely]] {
+                std::uint64_t word;
+                std::memcpy(&word, data.data() + position, sizeof(word));
+                auto continuations = word & 0x8080808080808080;
+
+                // Runs of single byte varints, such as small values,
+                // are widened a word at a time.
+                if (!(continuations & 0x80) &&
+                    count - i >= sizeof(word)) {
+                    for (std::size_t j = 0; j < sizeof(word); ++j) {
+                        span_type::from_unsigned(
+                            items[i + j],
+                            unsigned_type(data[position + j]));
+                    }
+                    auto run = std::size_t(std::countr_zero(continuations)) /
+                               CHAR_BIT;
+                    i += run;
+                    position += run;
+                    continue;
+                }
+
+                // Varints that end within the word are decoded from it.
+                if (auto stops = continuations ^ 0x8080808080808080) {
+                    auto size =
+                        std::size_t(std::countr_zero(stops)) / CHAR_BIT + 1;
+                    if constexpr (varint_max_size<unsigned_type> <
+                                  sizeof(word)) {
+                        if (size > varint_max_size<unsigned_type>)
+                            [[unlikely]] {
+                            archive.position() += position;
+                            return errc{std::errc::value_too_large};
+                        }
+                    }
+                    auto last = stops & (~stops + 1);
+                    span_type::from_unsigned(
+                        items[i],
+                        unsigned_type(kernels::compact_varint_word(
+                            word & (last ^ (last - 1)))));
+                    ++i;
+                    position += size;
+                    continue;
+                }
+            }
+        }
+
+        if (position == data.size()) [[unlikely]] {
+            archive.position() += position;
+            return errc{std::errc::result_out_of_range};
+        }
+        unsigned_type value{};
+        if (auto byte_value = std::uint8_t(data[position]);
+            byte_value < 0x80) {
+            value = byte_value;
+            ++position;
+        } else if (auto result = decode_varint(
+                       data.subspan(position), value, position);
+                   failure(result)) [[unlikely]] {
+            archive.position() += position;
+            return result;
+        }
+        span_type::from_unsigned(items[i], value);
+        ++i;
+    }
+
+    archive.position() += position;
+    return errc{};
+}
 
 #if !__has_include("zpp_basic_types.h")
 using vint32_t = varint<std::int32_t>;
@@ -1821,6 +3525,11 @@ struct size_varint : option<size_varint>
 {
     using default_size_type = vsize_t;
 };
+
+struct size_prefix_varint : option<size_prefix_varint>
+{
+    using default_size_type = varint<std::size_t, varint_encoding::prefix>;
+};
 } // namespace options
 
 constexpr decltype(auto) ZPP_BITS_INLINE
@@ -1834,6 +3543,243 @@ apply_serialize_as(auto protocol, auto && item)
     else
         return item;
 }
+namespace traits
+{
+template <typename ByteView>
+struct span_view
+{
+    using type = std::remove_cvref_t<decltype(
+        std::span{std::declval<ByteView &>()})>;
+};
+} // namespace traits
+
+constexpr auto unbounded_size = std::numeric_limits<std::size_t>::max();
+
+namespace traits
+{
+template <bool Exact, typename Type, typename... Options>
+constexpr std::size_t static_size();
+
+template <typename Type, typename... Options>
+constexpr std::size_t fixed_size();
+
+template <typename Type, typename... Options>
+constexpr std::size_t min_size();
+
+// Lengths of the runs of adjacent members that serialize as their bytes,
+// indexed by the first member of each run. The layout is predicted from the
+// member types, the archives verify it before copying a run.
+template <typename Archive, typename... Types>
+constexpr auto member_runs()
+{
+    constexpr std::array<std::size_t, sizeof...(Types)> sizes{
+        sizeof(Types)...};
+    constexpr std::array<std::size_t, sizeof...(Types)> alignments{
+        alignof(Types)...};
+    constexpr std::array<bool, sizeof...(Types)> as_bytes{
+        (concepts::serialize_as_bytes<Archive, Types> &&
+         !concepts::empty<Types>)...};
+
+    std::array<std::size_t, sizeof...(Types)> runs{};
+    std::size_t offset{};
+    std::size_t start{};
+    for (std::size_t i = 0; i < sizeof...(Types); ++i) {
+        auto aligned =
+            (offset + alignments[i] - 1) / alignments[i] * alignments[i];
+        if (i && as_bytes[i] && as_bytes[i - 1] && aligned == offset) {
+            ++runs[start];
+        } else {
+            start = i;
+            runs[start] = 1;
+        }
+        offset = aligned + sizes[i];
+    }
+    return runs;
+}
+
+template <typename Archive, typename... Types>
+constexpr auto has_member_runs()
+{
+    for (auto length : member_runs<Archive, Types...>()) {
+        if (length > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace traits
+
+namespace concepts
+{
+template <typename Type>
+concept fixed_span = requires
+{
+    requires std::same_as<
+        std::remove_cvref_t<Type>,
+        std::span<typename std::remove_cvref_t<Type>::element_type,
+                  std::remove_cvref_t<Type>::extent>>;
+    requires std::remove_cvref_t<Type>::extent != std::dynamic_extent;
+};
+} // namespace concepts
+
+namespace kernels
+{
+template <std::size_t Size>
+using unsigned_of_size = std::conditional_t<
+    Size == 2,
+    std::uint16_t,
+    std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>;
+
+constexpr auto byteswap(std::unsigned_integral auto value)
+{
+#ifdef __cpp_lib_byteswap
+    return std::byteswap(value);
+#else
+    decltype(value) result{};
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        result = decltype(value)((result << CHAR_BIT) | (value & 0xff));
+        value = decltype(value)(value >> CHAR_BIT);
+    }
+    return result;
+#endif
+}
+
+// Copies count elements of Size bytes from source to destination, reversing
+// the bytes of each element.
+template <std::size_t Size>
+inline void reverse_element_bytes_portable(unsigned char * destination,
+                                           const unsigned char * source,
+                                           std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        unsigned_of_size<Size> value;
+        std::memcpy(&value, source + i * Size, Size);
+        value = byteswap(value);
+        std::memcpy(destination + i * Size, &value, Size);
+    }
+}
+
+#if ZPP_BITS_X86_KERNELS
+// The shuffle that reverses every element of Size bytes in a 16 byte lane.
+template <std::size_t Size>
+constexpr auto reverse_element_bytes_shuffle()
+{
+    std::array<char, 32> shuffle{};
+    for (std::size_t i = 0; i < shuffle.size(); ++i) {
+        auto lane_index = i % 16;
+        shuffle[i] =
+            char(lane_index / Size * Size + (Size - 1 - lane_index % Size));
+    }
+    return shuffle;
+}
+
+template <std::size_t Size>
+[[gnu::target("ssse3")]] inline void
+reverse_element_bytes_ssse3(unsigned char * destination,
+                            const unsigned char * source,
+                            std::size_t count)
+{
+    static constexpr auto shuffle = reverse_element_bytes_shuffle<Size>();
+    auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffle.data()));
+    auto size = count * Size;
+    std::size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16) {
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(destination + offset),
+            _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                                 source + offset)),
+                             mask));
+    }
+    reverse_element_bytes_portable<Size>(
+        destination + offset, source + offset, (size - offset) / Size);
+}
+
+template <std::size_t Size>
+[[gnu::target("avx2")]] inline void
+reverse_element_bytes_avx2(unsigned char * destination,
+                           const unsigned char * source,
+                           std::size_t count)
+{
+    static constexpr auto shuffle = reverse_element_bytes_shuffle<Size>();
+    auto mask = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(shuffle.data()));
+    auto size = count * Size;
+    std::size_t offset = 0;
+    for (; offset + 32 <= size; offset += 32) {
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(destination + offset),
+            _mm256_shuffle_epi8(
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(source + offset)),
+                mask));
+    }
+    reverse_element_bytes_portable<Size>(
+        destination + offset, source + offset, (size - offset) / Size);
+}
+#endif
+
+// Copies count elements of Size bytes from source to destination, reversing
+// the bytes of each element, with the widest shuffles the processor has.
+template <std::size_t Size>
+inline void reverse_element_bytes(void * destination,
+                                  const void * source,
+                                  std::size_t count)
+{
+    auto to = static_cast<unsigned char *>(destination);
+    auto from = static_cast<const unsigned char *>(source);
+#if ZPP_BITS_X86_KERNELS
+#if defined __AVX2__
+    return reverse_element_bytes_avx2<Size>(to, from, count);
+#else
+    using kernel_type =
+        void (*)(unsigned char *, const unsigned char *, std::size_t);
+    static const kernel_type kernel = [] () -> kernel_type {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return reverse_element_bytes_avx2<Size>;
+        } else if (__builtin_cpu_supports("ssse3")) {
+            return reverse_element_bytes_ssse3<Size>;
+        }
+        return reverse_element_bytes_portable<Size>;
+    }();
+    return kernel(to, from, count);
+#endif
+#else
+    return reverse_element_bytes_portable<Size>(to, from, count);
+#endif
+}
+} // namespace kernels
+
+namespace concepts
+{
+// Fundamentals that are copied in bulk with their bytes reversed by
+// archives that swap the byte order.
+template <typename Archive, typename Type>
+concept swapped_bytes =
+    endian_aware_archive<Archive> &&
+    (std::is_fundamental_v<Type> || std::is_enum_v<Type>) &&
+    (sizeof(Type) == 2 || sizeof(Type) == 4 || sizeof(Type) == 8);
+} // namespace concepts
+
+template <typename... Options>
+class sizer;
+
+// The view of the sizer archive, which has no storage at all.
+struct sizer_view
+{
+    using value_type = std::byte;
+
+    constexpr std::byte * data() const
+    {
+        return nullptr;
+    }
+
+    constexpr std::size_t size() const
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+};
+
 template <concepts::byte_view ByteView, typename... Options>
 class basic_out
 {
@@ -1878,16 +3824,34 @@ public:
         (... ||
          std::same_as<std::remove_cvref_t<Options>, options::no_enlarge_overflow>);
 
-    constexpr static bool resizable = requires(ByteView view)
+    constexpr static auto align_arrays =
+        (... ||
+         std::same_as<std::remove_cvref_t<Options>, options::align_arrays>);
+
+    constexpr static bool measuring =
+        std::same_as<std::remove_cvref_t<ByteView>, sizer_view>;
+
+    constexpr static bool segmented = requires(ByteView view)
+    {
+        view.next_segment(std::size_t{}, std::size_t{});
+    };
+
+    constexpr static bool streaming = requires(ByteView view)
+    {
+        view.write(std::size_t{}, std::span<const std::byte>{});
+    };
+
+    constexpr static bool resizable = segmented || requires(ByteView view)
     {
         view.resize(1);
     };
 
-    using view_type =
-        std::conditional_t<resizable,
-                           ByteView &,
-                           std::remove_cvref_t<decltype(
-                               std::span{std::declval<ByteView &>()})>>;
+    using view_type = typename std::conditional_t<
+        resizable,
+        std::type_identity<ByteView &>,
+        std::conditional_t<measuring,
+                           std::type_identity<ByteView>,
+                           traits::span_view<ByteView>>>::type;
 
     constexpr explicit basic_out(ByteView && view, Options && ... options) : m_data(view)
     {
@@ -1895,14 +3859,29 @@ public:
         (options(*this), ...);
     }
 
-    constexpr explicit basic_out(ByteView & view, Options && ... options) : m_data(view)
+    constexpr explicit basic_out(ByteView & view, Options && ... options) :
+        m_data(view), m_options(stored_options(options...))
     {
+        if constexpr (segmented) {
+            m_position = m_data.committed();
+        }
         (options(*this), ...);
+        if constexpr (segmented) {
+            m_written = m_position;
+        } else if constexpr (resizable) {
+            m_written = m_data.size();
+        }
     }
 
     constexpr auto ZPP_BITS_INLINE operator()(auto &&... items)
     {
-        return serialize_many(items...);
+        if constexpr (resizable) {
+            auto result = serialize_many(items...);
+            m_written = std::max(m_written, m_position);
+            return result;
+        } else {
+            return serialize_many(items...);
+        }
     }
 
     constexpr decltype(auto) data()
@@ -1920,6 +3899,19 @@ public:
         return m_position;
     }
 
+    // The end of the bytes of a resizable view that were written, or that
+    // it held before. Past it, and past the position, the view only holds
+    // room reserved by enlarging it, which may be overwritten.
+    constexpr std::size_t written() const requires resizable
+    {
+        return m_written;
+    }
+
+    constexpr std::size_t & written() requires resizable
+    {
+        return m_written;
+    }
+
     constexpr auto remaining_data()
     {
         return std::span<byte_type>{m_data.data() + m_position,
@@ -1931,9 +3923,13 @@ public:
         return std::span<byte_type>{m_data.data(), m_position};
     }
 
+    // Unlike assigning the position, discards what was written past it.
     constexpr void reset(std::size_t position = 0)
     {
         m_position = position;
+        if constexpr (resizable) {
+            m_written = std::min(m_written, position);
+        }
     }
 
     constexpr static auto kind()
@@ -1944,7 +3940,29 @@ public:
     constexpr errc ZPP_BITS_INLINE enlarge_for(auto additional_size)
     {
         auto size = m_data.size();
-        if (additional_size > size - m_position) [[unlikely]] {
+        if constexpr (segmented) {
+            if (additional_size > size - m_position) [[unlikely]] {
+                if constexpr (allocation_limit !=
+                              std::numeric_limits<std::size_t>::max()) {
+                    auto offset = m_data.offset() + m_position;
+                    if (additional_size > allocation_limit - offset)
+                        [[unlikely]] {
+                        return std::errc::no_buffer_space;
+                    }
+                }
+                if constexpr (streaming) {
+                    if (auto result =
+                            m_data.next_segment(m_position, additional_size);
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+                } else {
+                    m_data.next_segment(m_position, additional_size);
+                }
+                m_position = 0;
+                m_written = 0;
+            }
+        } else if (additional_size > size - m_position) [[unlikely]] {
             constexpr auto multiplier = std::get<0>(enlarger);
             constexpr auto divisor = std::get<1>(enlarger);
             static_assert(multiplier != 0 && divisor != 0);
@@ -1996,10 +4014,52 @@ protected:
         return {};
     }
 
+    // Writes zeros up to the next multiple of Alignment in the output.
+    template <std::size_t Alignment>
+    constexpr errc pad()
+    {
+        auto position = m_position;
+        if constexpr (segmented) {
+            position += m_data.offset();
+        }
+        std::array<std::byte, Alignment> zeros{};
+        return serialize_one(bytes(std::span{
+            zeros.data(), (Alignment - position % Alignment) % Alignment}));
+    }
+
+    // The size of a sized message is written over a placeholder once the
+    // message is serialized. With align_arrays a varint size is written in
+    // its maximum size, so that the message is never moved ahead, which
+    // would misalign the arrays that were padded within it.
+    template <typename SizeType>
+    constexpr static std::size_t size_placeholder_size = [] {
+        if constexpr (!concepts::varint<SizeType>) {
+            return sizeof(SizeType);
+        } else if constexpr (align_arrays) {
+            return varint_max_size<typename SizeType::value_type,
+                                   SizeType::encoding>;
+        } else {
+            return varint_size<SizeType::encoding>(std::size_t{});
+        }
+    }();
+
+    template <typename SizeType>
+    constexpr errc serialize_size_placeholder()
+    {
+        if constexpr (concepts::varint<SizeType> && align_arrays) {
+            std::array<std::byte, size_placeholder_size<SizeType>> zeros{};
+            return serialize_one(bytes(std::span{zeros}));
+        } else {
+            return serialize_one(SizeType{});
+        }
+    }
+
     constexpr auto option(append)
     {
-        static_assert(resizable);
-        m_position = m_data.size();
+        static_assert(resizable || measuring);
+        if constexpr (!segmented && !measuring) {
+            m_position = m_data.size();
+        }
     }
 
     constexpr auto option(reserve size)
@@ -2031,6 +4091,17 @@ protected:
         } else if constexpr ( (std::is_aggregate_v<type> || concepts::has_pb_serialize<type>) 
             && !std::same_as<std::monostate, std::remove_cvref_t<decltype(protocol)>>) {
             return  serialize_one_with_protocol(protocol, std::forward<decltype(item)>(item));
+        } else if constexpr (measuring && (std::is_fundamental_v<type> ||
+                                           std::is_enum_v<type>)) {
+            m_position += sizeof(item);
+            return {};
+        } else if constexpr (measuring && requires {
+                                 requires std::same_as<
+                                     bytes<typename type::value_type>,
+                                     type>;
+                             }) {
+            m_position += item.size_in_bytes();
+            return {};
         } else if constexpr (std::is_fundamental_v<type> || std::is_enum_v<type>) {
             if constexpr (resizable) {
                 if (auto result = enlarge_for(sizeof(item));
@@ -2078,7 +4149,45 @@ protected:
                     std::remove_cvref_t<decltype(*item.data())>>);
 
             auto item_size_in_bytes = item.size_in_bytes();
-            if constexpr (resizable) {
+            if constexpr (segmented) {
+                auto source = reinterpret_cast<const std::byte *>(item.data());
+                if constexpr (streaming) {
+                    if (item_size_in_bytes >= m_data.size()) {
+                        if constexpr (allocation_limit !=
+                                      std::numeric_limits<std::size_t>::max()) {
+                            auto offset = m_data.offset() + m_position;
+                            if (item_size_in_bytes > allocation_limit - offset)
+                                [[unlikely]] {
+                                return std::errc::no_buffer_space;
+                            }
+                        }
+                        if (auto result = m_data.write(
+                                m_position, {source, item_size_in_bytes});
+                            failure(result)) [[unlikely]] {
+                            return result;
+                        }
+                        m_position = 0;
+                        m_written = 0;
+                        return {};
+                    }
+                }
+                while (item_size_in_bytes > m_data.size() - m_position) {
+                    if (auto count = m_data.size() - m_position) {
+                        std::memcpy(m_data.data() + m_position, source, count);
+                        source += count;
+                        item_size_in_bytes -= count;
+                        m_position += count;
+                    }
+                    if (auto result = enlarge_for(std::size_t{1});
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+                }
+                std::memcpy(
+                    m_data.data() + m_position, source, item_size_in_bytes);
+                m_position += item_size_in_bytes;
+                return {};
+            } else if constexpr (resizable) {
                 if (auto result = enlarge_for(item_size_in_bytes);
                     failure(result)) [[unlikely]] {
                     return result;
@@ -2127,12 +4236,121 @@ protected:
                 [&](auto &&... items) constexpr {
                     return serialize_many(items...);
                 });
+        } else if constexpr (batch_aggregate<type>()) {
+            constexpr auto size = traits::fixed_size<type, Options...>();
+            if constexpr (measuring) {
+                m_position += size;
+                return {};
+            } else {
+                if constexpr (resizable) {
+                    if (auto result = enlarge_for(size); failure(result))
+                        [[unlikely]] {
+                        return result;
+                    }
+                } else if (size > m_data.size() - m_position) [[unlikely]] {
+                    return std::errc::result_out_of_range;
+                }
+
+                auto archive = fixed_out<size>();
+                if (auto result = archive.serialize_one(item);
+                    failure(result)) [[unlikely]] {
+                    return result;
+                }
+                m_position += size;
+                return {};
+            }
+        } else {
+            return visit_members(
+                item,
+                [&](auto &&... items) ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {
+                    return serialize_members(items...);
+                });
+        }
+    }
+
+    // Runs of adjacent members that serialize as their bytes are copied at
+    // once, producing the same bytes as serializing them one by one.
+    constexpr errc ZPP_BITS_INLINE serialize_members(auto &&... items)
+    {
+        if constexpr (!traits::has_member_runs<
+                          basic_out,
+                          std::remove_cvref_t<decltype(items)>...>()) {
+            return serialize_many(items...);
+        } else {
+            if (std::is_constant_evaluated()) {
+                return serialize_many(items...);
+            }
+            auto members = std::forward_as_tuple(items...);
+            return serialize_runs<traits::member_runs<
+                basic_out,
+                std::remove_cvref_t<decltype(items)>...>()>(members);
+        }
+    }
+
+    template <auto Runs, std::size_t Index = 0>
+    constexpr errc ZPP_BITS_INLINE serialize_runs(auto & members)
+    {
+        if constexpr (Index == Runs.size()) {
+            return {};
+        } else {
+            constexpr auto length = Runs[Index];
+            if (auto result = [&]<std::size_t... Indices>(
+                    std::index_sequence<Indices...>)
+                    ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {
+                        if constexpr (length == 1) {
+                            return serialize_one(std::get<Index>(members));
+                        } else {
+                            auto & first = std::get<Index>(members);
+                            auto & last =
+                                std::get<Index + length - 1>(members);
+                            constexpr auto size =
+                                (0 + ... +
+                                 sizeof(std::get<Index + Indices>(members)));
+                            auto begin = reinterpret_cast<const std::byte *>(
+                                std::addressof(first));
+                            auto end = reinterpret_cast<const std::byte *>(
+                                           std::addressof(last)) +
+                                       sizeof(last);
+                            if (end - begin == std::ptrdiff_t(size)) {
+                                return serialize_one(
+                                    bytes(std::span{begin, size}));
+                            }
+                            return serialize_many(
+                                std::get<Index + Indices>(members)...);
+                        }
+                    }(std::make_index_sequence<length>());
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+            return serialize_runs<Runs, Index + length>(members);
+        }
+    }
+
+    // Aggregates of statically known size are bounds checked once, then
+    // written through a fixed extent span that needs no further checks.
+    template <typename Type>
+    constexpr static bool batch_aggregate()
+    {
+        if constexpr (concepts::fixed_span<ByteView>) {
+            return false;
         } else {
-            return visit_members(
-                item,
-                [&](auto &&... items) ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {
-                    return serialize_many(items...);
-                });
+            constexpr auto size = traits::fixed_size<Type, Options...>();
+            return size != unbounded_size && size != 0 &&
+                   number_of_members<Type>() > 1;
+        }
+    }
+
+    template <std::size_t Size>
+    constexpr auto ZPP_BITS_INLINE fixed_out()
+    {
+        using fixed_view = std::span<byte_type, Size>;
+        if constexpr (endian_aware) {
+            return basic_out<fixed_view, endian::swapped>{
+                fixed_view{m_data.data() + m_position, Size},
+                endian::swapped{}};
+        } else {
+            return basic_out<fixed_view>{
+                fixed_view{m_data.data() + m_position, Size}};
         }
     }
 
@@ -2144,6 +4362,9 @@ protected:
         if constexpr (concepts::serialize_as_bytes<decltype(*this),
                                                    value_type>) {
             return serialize_one(bytes(array));
+        } else if constexpr (concepts::swapped_bytes<decltype(*this),
+                                                     value_type>) {
+            return serialize_swapped(array, Count);
         } else {
             for (auto & item : array) {
                 if (auto result = serialize_one(item); failure(result))
@@ -2161,6 +4382,20 @@ protected:
     {
         using type = std::remove_cvref_t<decltype(container)>;
         using value_type = typename type::value_type;
+        constexpr auto contiguous_bytes =
+            concepts::serialize_as_bytes<decltype(*this), value_type> &&
+            std::is_base_of_v<std::random_access_iterator_tag,
+                              typename std::iterator_traits<
+                                  typename type::iterator>::iterator_category> &&
+            requires { container.data(); };
+        constexpr auto grouped_varints = [] {
+            if constexpr (concepts::varint<value_type>) {
+                return value_type::encoding == varint_encoding::group &&
+                       requires(type container) { std::span{container}; };
+            } else {
+                return false;
+            }
+        }();
 
         if constexpr (!std::is_void_v<SizeType> &&
                       (
@@ -2180,16 +4415,26 @@ protected:
                 failure(result)) [[unlikely]] {
                 return result;
             }
+
+            if constexpr (align_arrays && contiguous_bytes &&
+                          alignof(value_type) > 1) {
+                if (auto result = pad<alignof(value_type)>();
+                    failure(result)) [[unlikely]] {
+                    return result;
+                }
+            }
         }
 
-        if constexpr (concepts::serialize_as_bytes<decltype(*this),
-                                                   value_type> &&
-                      std::is_base_of_v<std::random_access_iterator_tag,
-                                        typename std::iterator_traits<
-                                            typename type::iterator>::
-                                            iterator_category> &&
-                      requires { container.data(); }) {
+        if constexpr (concepts::bit_vector<type>) {
+            return serialize_bits(container, container.size());
+        } else if constexpr (contiguous_bytes) {
             return serialize_one(bytes(container));
+        } else if constexpr (concepts::swapped_bytes<decltype(*this),
+                                                     value_type> &&
+                             requires { container.data(); }) {
+            return serialize_swapped(container.data(), container.size());
+        } else if constexpr (grouped_varints) {
+            return serialize_one(varint_span(container));
         } else {
             for (auto & item : container) {
                 if (auto result = serialize_one(item); failure(result))
@@ -2269,7 +4514,42 @@ protected:
         constexpr auto size = std::remove_cvref_t<decltype(bitset)>{}.size();
         constexpr auto size_in_bytes = (size + (CHAR_BIT - 1)) / CHAR_BIT;
 
-        if constexpr (resizable) {
+        if constexpr (measuring) {
+            m_position += size_in_bytes;
+            return {};
+        } else if constexpr (resizable) {
+            if (auto result = enlarge_for(size_in_bytes);
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+        } else if (size_in_bytes > m_data.size() - m_position)
+            [[unlikely]] {
+            return std::errc::result_out_of_range;
+        }
+
+        if constexpr (traits::bitset_bytes_in_order<
+                          std::remove_cvref_t<decltype(bitset)>>()) {
+            if (!std::is_constant_evaluated()) {
+                std::memcpy(m_data.data() + m_position,
+                            std::addressof(bitset),
+                            size_in_bytes);
+                m_position += size_in_bytes;
+                return {};
+            }
+        }
+
+        return serialize_bits(bitset, size);
+    }
+
+    // Packs size bits, lowest first, into the bytes that follow, eight at a
+    // time.
+    constexpr errc serialize_bits(auto && bits, std::size_t size)
+    {
+        auto size_in_bytes = size / CHAR_BIT + bool(size % CHAR_BIT);
+        if constexpr (measuring) {
+            m_position += size_in_bytes;
+            return {};
+        } else if constexpr (resizable) {
             if (auto result = enlarge_for(size_in_bytes);
                 failure(result)) [[unlikely]] {
                 return result;
@@ -2279,17 +4559,104 @@ protected:
             return std::errc::result_out_of_range;
         }
 
+        // Containers are walked with iterators, which are cheaper than
+        // indexing into std::vector<bool>.
+        auto & values = std::as_const(bits);
+        auto position = [&] {
+            if constexpr (requires { values.begin(); }) {
+                return values.begin();
+            } else {
+                return std::size_t{};
+            }
+        }();
+        auto next = [&] {
+            if constexpr (requires { values.begin(); }) {
+                return bool(*position++);
+            } else {
+                return bool(values[position++]);
+            }
+        };
+
         auto data = m_data.data() + m_position;
-        for (std::size_t i = 0; i < size; ++i) {
-            auto & value = data[i / CHAR_BIT];
-            value = byte_type(static_cast<unsigned char>(value) |
-                              (bitset[i] << (i & 0x7)));
+        std::size_t index = 0;
+        for (; index + CHAR_BIT <= size; index += CHAR_BIT) {
+            unsigned char value{};
+            for (std::size_t bit = 0; bit < CHAR_BIT; ++bit) {
+                value |= static_cast<unsigned char>(next() << bit);
+            }
+            *data++ = byte_type(value);
+        }
+        if (index < size) {
+            unsigned char value{};
+            for (std::size_t bit = 0; index + bit < size; ++bit) {
+                value |= static_cast<unsigned char>(next() << bit);
+            }
+            *data = byte_type(value);
         }
 
         m_position += size_in_bytes;
         return {};
     }
 
+    // Writes count contiguous fundamentals with their bytes reversed, in
+    // bulk rather than one at a time.
+    constexpr errc serialize_swapped(const auto * elements, std::size_t count)
+    {
+        constexpr auto size = sizeof(*elements);
+
+        if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (auto result = serialize_one(elements[i]); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+            return {};
+        }
+
+        if constexpr (measuring) {
+            m_position += count * size;
+            return {};
+        } else if constexpr (segmented) {
+            // Elements are not split between segments.
+            while (count) {
+                auto fit = std::min(count, (m_data.size() - m_position) / size);
+                if (!fit) {
+                    if (auto result = enlarge_for(size); failure(result))
+                        [[unlikely]] {
+                        return result;
+                    }
+                    continue;
+                }
+                kernels::reverse_element_bytes<size>(
+                    m_data.data() + m_position, elements, fit);
+                elements += fit;
+                count -= fit;
+                m_position += fit * size;
+            }
+            return {};
+        } else {
+            if (count > std::numeric_limits<std::size_t>::max() / size)
+                [[unlikely]] {
+                return std::errc::message_size;
+            }
+            if constexpr (resizable) {
+                if (auto result = enlarge_for(count * size); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            } else if (count * size > m_data.size() - m_position)
+                [[unlikely]] {
+                return std::errc::result_out_of_range;
+            }
+
+            kernels::reverse_element_bytes<size>(
+                m_data.data() + m_position, elements, count);
+            m_position += count * size;
+            return {};
+        }
+    }
+
     template <typename SizeType>
     constexpr errc ZPP_BITS_INLINE serialize_one(concepts::unspecialized auto && item) requires 
         (!std::same_as<std::monostate, std::remove_cvref_t<decltype(protocol)>> )
@@ -2315,67 +4682,252 @@ public:
     template <typename SizeType>
     constexpr errc ZPP_BITS_INLINE serialize_sized(auto&& serializer) 
     {
-        auto size_position = m_position;
-        if (auto result = serialize_one(SizeType{});
-            failure(result)) [[unlikely]] {
-            return result;
-        }
+        if constexpr (measuring) {
+            return serialize_sized_measuring<SizeType>(serializer);
+        } else if constexpr (streaming) {
+            return serialize_sized_streaming<SizeType>(serializer);
+        } else if constexpr (segmented) {
+            return serialize_sized_segmented<SizeType>(serializer);
+        } else {
+            auto size_position = m_position;
+            if (auto result = serialize_size_placeholder<SizeType>();
+                failure(result)) [[unlikely]] {
+                return result;
+            }
 
-        if (auto result = serializer(); failure(result))
-            [[unlikely]] {
+            if (auto result = serializer(*this); failure(result))
+                [[unlikely]] {
                 return result;
-        }
+            }
 
-        auto current_position = m_position;
-        std::size_t message_size =
-                current_position - size_position - sizeof(SizeType);
-        if constexpr (concepts::varint<SizeType>) {
-            constexpr auto preserialized_varint_size = 1;
-            message_size = current_position - size_position -
-                            preserialized_varint_size;
-            auto move_ahead_count =
-                varint_size(message_size) - preserialized_varint_size;
-            if (move_ahead_count) {
-                if constexpr (resizable) {
-                    if (auto result = enlarge_for(move_ahead_count);
-                        failure(result)) [[unlikely]] {
-                        return result;
+            auto current_position = m_position;
+            std::size_t message_size = current_position - size_position -
+                                       size_placeholder_size<SizeType>;
+            if constexpr (concepts::varint<SizeType> && align_arrays) {
+                encode_varint_max_size<typename SizeType::value_type,
+                                       SizeType::encoding>(
+                    message_size, m_data.data() + size_position);
+                return {};
+            } else if constexpr (concepts::varint<SizeType>) {
+                constexpr auto preserialized_varint_size =
+                    size_placeholder_size<SizeType>;
+                auto move_ahead_count =
+                    varint_size<SizeType::encoding>(message_size) -
+                    preserialized_varint_size;
+                if (move_ahead_count) {
+                    if constexpr (resizable) {
+                        if (auto result = enlarge_for(move_ahead_count);
+                            failure(result)) [[unlikely]] {
+                            return result;
+                        }
+                    } else if (move_ahead_count >
+                               m_data.size() - current_position)
+                        [[unlikely]] {
+                        return std::errc::result_out_of_range;
                     }
-                } else if (move_ahead_count >
-                            m_data.size() - current_position)
-                    [[unlikely]] {
-                    return std::errc::result_out_of_range;
-                }
-                auto data = m_data.data();
-                auto message_start =
-                    data + size_position + preserialized_varint_size;
-                auto message_end = data + current_position;
-                if (std::is_constant_evaluated()) {
-                    for (auto p = message_end - 1; p >= message_start;
-                            --p) {
-                        *(p + move_ahead_count) = *p;
+                    auto data = m_data.data();
+                    auto message_start =
+                        data + size_position + preserialized_varint_size;
+                    auto message_end = data + current_position;
+                    if (std::is_constant_evaluated()) {
+                        for (auto p = message_end - 1; p >= message_start;
+                             --p) {
+                            *(p + move_ahead_count) = *p;
+                        }
+                    } else {
+                        std::memmove(message_start + move_ahead_count,
+                                     message_start,
+                                     message_size);
                     }
-                } else {
-                    std::memmove(message_start + move_ahead_count,
-                                    message_start,
-                                    message_size);
+                    m_position += move_ahead_count;
                 }
-                m_position += move_ahead_count;
+                // The window is exactly the size of the encoding, so that
+                // it is not written past into the message.
+                return basic_out<std::span<byte_type>>{std::span<byte_type>{
+                    m_data.data() + size_position,
+                    preserialized_varint_size + move_ahead_count}}(
+                    SizeType(message_size));
+            } else {
+                return basic_out<std::span<byte_type, sizeof(SizeType)>>{
+                    std::span<byte_type, sizeof(SizeType)>{
+                        m_data.data() + size_position, sizeof(SizeType)}}(
+                    SizeType(message_size));
             }
         }
-        return basic_out<std::span<byte_type, sizeof(SizeType)>>{
-            std::span<byte_type, sizeof(SizeType)>{
-                m_data.data() + size_position, sizeof(SizeType)}}(
-            SizeType(message_size));
     }
 protected:
+    template <typename SizeType>
+    constexpr errc serialize_sized_measuring(auto && serializer)
+    {
+        // Measured sizes are recorded in the order of the messages.
+        std::size_t index{};
+        if (m_measured_sizes) {
+            index = m_measured_sizes->size();
+            m_measured_sizes->push_back(0);
+        }
+
+        constexpr auto preserialized_size = size_placeholder_size<SizeType>;
+        auto message_position = m_position += preserialized_size;
+        if (auto result = serializer(*this); failure(result)) [[unlikely]] {
+            return result;
+        }
+        std::size_t message_size = m_position - message_position;
+        if constexpr (concepts::varint<SizeType> && !align_arrays) {
+            m_position += varint_size<SizeType::encoding>(message_size) -
+                          preserialized_size;
+        }
+
+        if (m_measured_sizes) {
+            (*m_measured_sizes)[index] = message_size;
+        }
+        return {};
+    }
+
+    // Written bytes never move in a segmented view, so the size is patched
+    // through a pointer. When a varint size needs more than its placeholder
+    // byte, the message is moved ahead if it is still within the window,
+    // otherwise the extra bytes are inserted as a segment of their own.
+    template <typename SizeType>
+    constexpr errc serialize_sized_segmented(auto && serializer)
+    {
+        if (auto result = serialize_size_placeholder<SizeType>();
+            failure(result)) [[unlikely]] {
+            return result;
+        }
+
+        constexpr auto preserialized_size = size_placeholder_size<SizeType>;
+        auto size_data = m_data.data() + m_position - preserialized_size;
+        auto window_offset = m_data.offset();
+        auto message_offset = window_offset + m_position;
+
+        if (auto result = serializer(*this); failure(result)) [[unlikely]] {
+            return result;
+        }
+
+        std::size_t message_size =
+            m_data.offset() + m_position - message_offset;
+        if constexpr (concepts::varint<SizeType> && align_arrays) {
+            encode_varint_max_size<typename SizeType::value_type,
+                                   SizeType::encoding>(message_size,
+                                                       size_data);
+            return {};
+        } else if constexpr (concepts::varint<SizeType>) {
+            std::array<byte_type,
+                       varint_max_size<typename SizeType::value_type,
+                                       SizeType::encoding>>
+                encoded;
+            basic_out<std::span<byte_type>> size_out{std::span{encoded}};
+            if (auto result = size_out(SizeType(message_size));
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+
+            std::copy_n(encoded.begin(), preserialized_size, size_data);
+            auto extra = std::span{encoded}.subspan(
+                preserialized_size, size_out.position() - preserialized_size);
+            if (extra.empty()) {
+                return {};
+            }
+
+            if (window_offset == m_data.offset() &&
+                extra.size() <= m_data.size() - m_position) {
+                auto message_start = size_data + preserialized_size;
+                std::memmove(
+                    message_start + extra.size(), message_start, message_size);
+                std::copy(extra.begin(), extra.end(), message_start);
+                m_position += extra.size();
+            } else {
+                m_data.insert(m_position, message_offset, extra);
+                m_position = 0;
+                m_written = 0;
+            }
+            return {};
+        } else {
+            return basic_out<std::span<byte_type, sizeof(SizeType)>>{
+                std::span<byte_type, sizeof(SizeType)>{size_data,
+                                                       sizeof(SizeType)}}(
+                SizeType(message_size));
+        }
+    }
+
+    // Bytes that were written to the sink cannot be patched, so the message
+    // is measured first, with the options of this archive, and then
+    // serialized after its size. The sized messages within it are measured
+    // along with it, and their sizes are used when they are serialized, so
+    // that every level is measured once. The measurement starts at the
+    // offset of the message in the stream, on which the padding of its
+    // arrays depends.
+    template <typename SizeType>
+    constexpr errc serialize_sized_streaming(auto && serializer)
+    {
+        auto & [sizes, next] = m_message_sizes;
+        auto fail = [&](errc result) {
+            sizes.clear();
+            next = 0;
+            return result;
+        };
+
+        std::size_t message_size{};
+        if (next < sizes.size()) {
+            message_size = sizes[next++];
+        } else {
+            sizes.clear();
+            next = 0;
+            auto measure = std::apply(
+                [](auto... options) {
+                    return sizer<std::remove_cvref_t<Options>...>{
+                        std::move(options)...};
+                },
+                m_options);
+            static_cast<basic_out<sizer_view, std::remove_cvref_t<Options>...> &>(
+                measure)
+                .m_measured_sizes = &sizes;
+            auto message_offset = m_data.offset() + m_position +
+                                  size_placeholder_size<SizeType>;
+            measure.position() = message_offset;
+            if (auto result = serializer(measure); failure(result))
+                [[unlikely]] {
+                return fail(result);
+            }
+            message_size = measure.position() - message_offset;
+        }
+
+        if constexpr (concepts::varint<SizeType> && align_arrays) {
+            std::array<std::byte, size_placeholder_size<SizeType>> encoded;
+            encode_varint_max_size<typename SizeType::value_type,
+                                   SizeType::encoding>(message_size,
+                                                       encoded.data());
+            if (auto result = serialize_one(
+                    bytes(std::span{encoded.data(), encoded.size()}));
+                failure(result)) [[unlikely]] {
+                return fail(result);
+            }
+        } else if (auto result = serialize_one(SizeType(message_size));
+                   failure(result)) [[unlikely]] {
+            return fail(result);
+        }
+        if (auto result = serializer(*this); failure(result)) [[unlikely]] {
+            return fail(result);
+        }
+        return {};
+    }
+
+    constexpr static auto stored_options(auto &... options)
+    {
+        if constexpr (streaming) {
+            return std::tuple<std::remove_cvref_t<Options>...>{options...};
+        } else {
+            return std::tuple<>{};
+        }
+    }
+
     template <typename SizeType = default_size_type>
     constexpr errc ZPP_BITS_INLINE serialize_one_with_protocol(auto protocol, auto && item)
     {
         if constexpr (std::same_as<decltype(protocol), std::monostate>) {
             return serialize_one<SizeType>(item);
         } else if constexpr (!std::is_void_v<SizeType>) {
-            return serialize_sized<SizeType>( [this, &item, protocol]() ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {  return protocol(*this, item); });
+            return serialize_sized<SizeType>( [&item, protocol](auto & archive) ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {  return protocol(archive, item); });
         } else {
             return protocol(*this, item);
         }
@@ -2383,8 +4935,28 @@ protected:
 
     constexpr ~basic_out() = default;
 
+    // The sizes of the sized messages within a message that is streamed, in
+    // the order that they are serialized, and the next one to use.
+    struct message_sizes
+    {
+        std::vector<std::size_t> sizes;
+        std::size_t next{};
+    };
+
     view_type m_data{};
     std::size_t m_position{};
+    [[no_unique_address]] std::
+        conditional_t<resizable, std::size_t, std::monostate> m_written{};
+    [[no_unique_address]] std::conditional_t<
+        streaming,
+        std::tuple<std::remove_cvref_t<Options>...>,
+        std::tuple<>> m_options{};
+    [[no_unique_address]] std::
+        conditional_t<streaming, message_sizes, std::monostate>
+            m_message_sizes{};
+    [[no_unique_address]] std::
+        conditional_t<measuring, std::vector<std::size_t> *, std::monostate>
+            m_measured_sizes{};
 };
 
 template <concepts::byte_view ByteView = std::vector<std::byte>, typename... Options>
@@ -2399,6 +4971,7 @@ public:
 
     friend access;
 
+    using base::segmented;
     using base::resizable;
     using base::enlarger;
 
@@ -2408,51 +4981,304 @@ public:
 
     constexpr auto ZPP_BITS_INLINE operator()(auto &&... items)
     {
-        if constexpr (resizable && !no_fit_size &&
+        if constexpr (segmented) {
+            auto result = serialize_many(items...);
+            m_data.commit(m_position);
+            m_written = std::max(m_written, m_position);
+            return result;
+        } else if constexpr (resizable && !no_fit_size &&
                       enlarger != std::tuple{1, 1}) {
             auto end = m_data.size();
             auto result = serialize_many(items...);
             if (m_position >= end) {
                 m_data.resize(m_position);
             }
+            m_written = std::max(m_written, m_position);
+            return result;
+        } else if constexpr (resizable) {
+            auto result = serialize_many(items...);
+            m_written = std::max(m_written, m_position);
             return result;
         } else {
-            return serialize_many(items...);
+            return serialize_many(items...);
+        }
+    }
+
+private:
+    using base::serialize_many;
+    using base::m_data;
+    using base::m_position;
+    using base::m_written;
+};
+
+template <typename Type, typename... Options>
+out(Type &, Options &&...) -> out<Type, Options...>;
+
+template <typename Type, typename... Options>
+out(Type &&, Options &&...) -> out<Type, Options...>;
+
+template <typename Type, std::size_t Size, typename... Options>
+out(Type (&)[Size], Options &&...)
+    -> out<std::span<Type, Size>, Options...>;
+
+template <typename Type, typename SizeType, typename... Options>
+out(sized_item<Type, SizeType> &, Options &&...)
+    -> out<Type, Options...>;
+
+template <typename Type, typename SizeType, typename... Options>
+out(const sized_item<Type, SizeType> &, Options &&...)
+    -> out<const Type, Options...>;
+
+template <typename Type, typename SizeType, typename... Options>
+out(sized_item<Type, SizeType> &&, Options &&...) -> out<Type, Options...>;
+
+// An output archive that runs the regular serialization but only
+// advances its position, so that position() is the serialized size.
+template <typename... Options>
+class sizer : public out<sizer_view, Options...>
+{
+public:
+    using base = out<sizer_view, Options...>;
+
+    constexpr explicit sizer(Options &&... options) :
+        base(sizer_view{}, std::forward<Options>(options)...)
+    {
+    }
+};
+
+template <typename... Options>
+sizer(Options &&...) -> sizer<Options...>;
+
+namespace traits
+{
+constexpr std::size_t max_size_sum(auto... sizes)
+{
+    std::size_t sum = 0;
+    for (std::size_t size : {std::size_t{}, std::size_t(sizes)...}) {
+        if (size > unbounded_size - sum) {
+            return unbounded_size;
+        }
+        sum += size;
+    }
+    return sum;
+}
+
+constexpr std::size_t max_size_product(std::size_t count, std::size_t size)
+{
+    if (count && size > unbounded_size / count) {
+        return unbounded_size;
+    }
+    return count * size;
+}
+
+template <bool Exact, typename... Options>
+struct static_size_visitor
+{
+    template <typename... Types>
+    constexpr auto operator()()
+    {
+        return std::integral_constant<
+            std::size_t,
+            max_size_sum(static_size<Exact, Types, Options...>()...)>{};
+    }
+};
+
+template <typename Variant, typename... Options, std::size_t... Indices>
+constexpr std::size_t max_variant_size(std::index_sequence<Indices...>)
+{
+    return std::max(
+        {max_size_sum(
+             sizeof(decltype(variant<Variant>::template id<Indices>())),
+             static_size<false,
+                         std::variant_alternative_t<Indices, Variant>,
+                         Options...>())...});
+}
+
+// Follows the dispatch of basic_out::serialize_one. Anything whose size
+// depends on its value, or that has a custom serialize function, is
+// unbounded. When Exact is set, so is anything whose size may vary.
+template <bool Exact, typename Type, typename... Options>
+constexpr std::size_t static_size()
+{
+    using type = std::remove_cvref_t<Type>;
+    constexpr auto protocol = protocol_from_options<Options...>();
+
+    if constexpr (concepts::varint<type>) {
+        if constexpr (Exact) {
+            return unbounded_size;
+        } else {
+            return varint_max_size<typename type::value_type,
+                                   type::encoding>;
+        }
+    } else if constexpr (concepts::has_explicit_serialize<type> ||
+                         concepts::by_protocol<type> ||
+                         concepts::owning_pointer<type>) {
+        return unbounded_size;
+    } else if constexpr (concepts::empty<type>) {
+        return 0;
+    } else if constexpr ((std::is_aggregate_v<type> ||
+                          concepts::has_pb_serialize<type>) &&
+                         !std::same_as<std::monostate,
+                                       std::remove_cvref_t<decltype(
+                                           protocol)>>) {
+        return unbounded_size;
+    } else if constexpr (std::is_fundamental_v<type> ||
+                         std::is_enum_v<type> ||
+                         concepts::serialize_as_bytes<sizer<Options...>,
+                                                      type>) {
+        return sizeof(type);
+    } else if constexpr (std::is_array_v<type>) {
+        return max_size_product(
+            std::extent_v<type>,
+            static_size<Exact, std::remove_extent_t<type>, Options...>());
+    } else if constexpr (concepts::bitset<type>) {
+        return (type{}.size() + (CHAR_BIT - 1)) / CHAR_BIT;
+    } else if constexpr (Exact && (concepts::optional<type> ||
+                                   concepts::variant<type>)) {
+        return unbounded_size;
+    } else if constexpr (concepts::optional<type>) {
+        return max_size_sum(
+            1, static_size<false, typename type::value_type, Options...>());
+    } else if constexpr (concepts::variant<type>) {
+        return max_variant_size<type, Options...>(
+            std::make_index_sequence<std::variant_size_v<type>>());
+    } else if constexpr (concepts::tuple<type>) {
+        return []<std::size_t... Indices>(std::index_sequence<Indices...>)
+        {
+            return max_size_sum(
+                static_size<Exact,
+                            std::tuple_element_t<Indices, type>,
+                            Options...>()...);
+        }
+        (std::make_index_sequence<std::tuple_size_v<type>>());
+    } else if constexpr (concepts::container<type>) {
+        if constexpr (requires {
+                          requires type::extent != std::dynamic_extent;
+                      }) {
+            return max_size_product(
+                type::extent,
+                static_size<Exact, typename type::value_type, Options...>());
+        } else if constexpr (requires {
+                                 requires std::tuple_size<type>::value >= 0;
+                             }) {
+            return max_size_product(
+                std::tuple_size_v<type>,
+                static_size<Exact, typename type::value_type, Options...>());
+        } else {
+            return unbounded_size;
         }
+    } else if constexpr (number_of_members<type>() < 0) {
+        return unbounded_size;
+    } else {
+        return decltype(visit_members_types<type>(
+            static_size_visitor<Exact, Options...>{}))::value;
     }
-
-private:
-    using base::serialize_many;
-    using base::m_data;
-    using base::m_position;
-};
+}
 
 template <typename Type, typename... Options>
-out(Type &, Options &&...) -> out<Type, Options...>;
+constexpr std::size_t max_size()
+{
+    return static_size<false, Type, Options...>();
+}
 
 template <typename Type, typename... Options>
-out(Type &&, Options &&...) -> out<Type, Options...>;
-
-template <typename Type, std::size_t Size, typename... Options>
-out(Type (&)[Size], Options &&...)
-    -> out<std::span<Type, Size>, Options...>;
+constexpr std::size_t fixed_size()
+{
+    return static_size<true, Type, Options...>();
+}
 
-template <typename Type, typename SizeType, typename... Options>
-out(sized_item<Type, SizeType> &, Options &&...)
-    -> out<Type, Options...>;
+template <typename... Options>
+struct min_size_visitor
+{
+    template <typename... Types>
+    constexpr auto operator()()
+    {
+        return std::integral_constant<
+            std::size_t,
+            max_size_sum(min_size<Types, Options...>()...)>{};
+    }
+};
 
-template <typename Type, typename SizeType, typename... Options>
-out(const sized_item<Type, SizeType> &, Options &&...)
-    -> out<const Type, Options...>;
+// A lower bound of the encoded size of Type, following static_size(), to
+// bound the number of elements that the remaining input can hold. Types
+// with custom serialization are assumed to encode to nothing.
+template <typename Type, typename... Options>
+constexpr std::size_t min_size()
+{
+    using type = std::remove_cvref_t<Type>;
+    using size_type = default_size_type_t<Options...>;
+    constexpr auto protocol = protocol_from_options<Options...>();
+    if constexpr (concepts::varint<type>) {
+        return 1;
+    } else if constexpr (concepts::has_explicit_serialize<type> ||
+                         concepts::by_protocol<type> ||
+                         concepts::owning_pointer<type> ||
+                         concepts::empty<type>) {
+        return 0;
+    } else if constexpr ((std::is_aggregate_v<type> ||
+                          concepts::has_pb_serialize<type>) &&
+                         !std::same_as<std::monostate,
+                                       std::remove_cvref_t<decltype(
+                                           protocol)>>) {
+        return 0;
+    } else if constexpr (constexpr auto size =
+                             static_size<true, type, Options...>();
+                         size != unbounded_size) {
+        return size;
+    } else if constexpr (std::is_array_v<type>) {
+        return max_size_product(
+            std::extent_v<type>,
+            min_size<std::remove_extent_t<type>, Options...>());
+    } else if constexpr (concepts::optional<type>) {
+        return 1;
+    } else if constexpr (concepts::variant<type>) {
+        return sizeof(decltype(variant<type>::template id<0>()));
+    } else if constexpr (concepts::tuple<type>) {
+        return []<std::size_t... Indices>(std::index_sequence<Indices...>)
+        {
+            return max_size_sum(
+                min_size<std::tuple_element_t<Indices, type>,
+                         Options...>()...);
+        }
+        (std::make_index_sequence<std::tuple_size_v<type>>());
+    } else if constexpr (concepts::container<type>) {
+        if constexpr (requires {
+                          requires type::extent != std::dynamic_extent;
+                      }) {
+            return max_size_product(
+                type::extent,
+                min_size<typename type::value_type, Options...>());
+        } else if constexpr (requires {
+                                 requires std::tuple_size<type>::value >= 0;
+                             }) {
+            return max_size_product(
+                std::tuple_size_v<type>,
+                min_size<typename type::value_type, Options...>());
+        } else if constexpr (std::is_void_v<size_type>) {
+            return 0;
+        } else {
+            return min_size<size_type, Options...>();
+        }
+    } else if constexpr (number_of_members<type>() < 0) {
+        return 0;
+    } else {
+        return decltype(visit_members_types<type>(
+            min_size_visitor<Options...>{}))::value;
+    }
+}
+} // namespace traits
 
-template <typename Type, typename SizeType, typename... Options>
-out(sized_item<Type, SizeType> &&, Options &&...) -> out<Type, Options...>;
+template <typename Type, typename... Options>
+constexpr auto max_size_v = traits::max_size<Type, Options...>();
 
 template <concepts::byte_view ByteView = std::vector<std::byte>,
           typename... Options>
 class in
 {
 public:
+    template <concepts::byte_view, typename...>
+    friend class in;
+
     template <typename... Types>
     using template_type = in<Types...>;
 
@@ -2486,20 +5312,40 @@ public:
 
     constexpr static auto protocol = traits::protocol_from_options<Options...>();
 
+    constexpr static auto align_arrays =
+        (... ||
+         std::same_as<std::remove_cvref_t<Options>, options::align_arrays>);
+
+    constexpr static auto copy_misaligned =
+        (... ||
+         std::same_as<std::remove_cvref_t<Options>, options::copy_misaligned>);
+
+    constexpr static auto reuse =
+        (... || std::same_as<std::remove_cvref_t<Options>, options::reuse>);
+
     constexpr explicit in(ByteView && view, Options && ... options) : m_data(view)
     {
-        static_assert(!resizable);
+        static_assert(!resizable && !streaming);
         (options(*this), ...);
     }
 
     constexpr explicit in(ByteView & view, Options && ... options) : m_data(view)
     {
+        if constexpr (streaming) {
+            m_position = m_data.committed();
+        }
         (options(*this), ...);
     }
 
     constexpr auto ZPP_BITS_INLINE operator()(auto &&... items)
     {
-        return serialize_many(items...);
+        if constexpr (streaming) {
+            auto result = serialize_many(items...);
+            m_data.commit(m_position);
+            return result;
+        } else {
+            return serialize_many(items...);
+        }
     }
 
     constexpr decltype(auto) data()
@@ -2507,6 +5353,11 @@ public:
         return m_data;
     }
 
+    constexpr auto option(options::copy_misaligned storage)
+    {
+        m_misaligned_storage = storage.storage;
+    }
+
     constexpr std::size_t position() const
     {
         return m_position;
@@ -2533,6 +5384,55 @@ public:
         m_position = position;
     }
 
+    // The number of bytes that were missing when the input ran short,
+    // zero if unknown.
+    constexpr std::size_t shortfall() const
+    {
+        return m_shortfall;
+    }
+
+    // Decodes the members of an aggregate that Members point to, and skips
+    // the others, see skip().
+    template <auto... Members>
+    constexpr errc project(auto & item)
+    {
+        using type = std::remove_cvref_t<decltype(item)>;
+        static_assert((... && std::is_member_object_pointer_v<
+                                  decltype(Members)>));
+        static_assert(std::is_class_v<type> &&
+                          concepts::unspecialized<type> &&
+                          !concepts::has_serialize<type> &&
+                          std::same_as<std::remove_cvref_t<decltype(protocol)>,
+                                       std::monostate>,
+                      "Projection needs members serialized in order.");
+
+        auto result = visit_members(item, [&](auto &... members) constexpr {
+            return project_members<traits::member_mask<type, Members...>()>(
+                std::make_index_sequence<sizeof...(members)>(), members...);
+        });
+
+        if constexpr (streaming) {
+            m_data.commit(m_position);
+        }
+        return result;
+    }
+
+    // Moves the position past an encoded Type without decoding it where
+    // possible. Fixed size types and sized arrays of byte serializable
+    // or fixed size elements are skipped at once, other types are walked,
+    // and types with custom serialization are decoded into a temporary.
+    template <typename Type>
+    constexpr errc skip()
+    {
+        if constexpr (streaming) {
+            auto result = skip_one<Type>();
+            m_data.commit(m_position);
+            return result;
+        } else {
+            return skip_one<Type>();
+        }
+    }
+
     constexpr static auto kind()
     {
         return kind::in;
@@ -2543,11 +5443,33 @@ public:
         view.resize(1);
     };
 
-    using view_type =
-        std::conditional_t<resizable,
-                           ByteView &,
-                           std::remove_cvref_t<decltype(
-                               std::span{std::declval<ByteView &>()})>>;
+    constexpr static bool streaming = requires(ByteView view)
+    {
+        view.refill(std::size_t{}, std::size_t{});
+    };
+
+    // Refills a streaming view so that at least size bytes follow the
+    // position, unless the input ends first.
+    constexpr errc refill(std::size_t size) requires streaming
+    {
+        if constexpr (allocation_limit !=
+                      std::numeric_limits<std::size_t>::max()) {
+            if (size > allocation_limit) [[unlikely]] {
+                return std::errc::message_size;
+            }
+        }
+        if (auto result = m_data.refill(m_position, size); failure(result))
+            [[unlikely]] {
+            return result;
+        }
+        m_position = 0;
+        return {};
+    }
+
+    using view_type = typename std::conditional_t<
+        resizable || streaming,
+        std::type_identity<ByteView &>,
+        traits::span_view<ByteView>>::type;
 
 private:
     constexpr errc ZPP_BITS_INLINE serialize_many(auto && first_item,
@@ -2566,6 +5488,341 @@ private:
         return {};
     }
 
+    // Makes a sized message of a streaming input available as a whole.
+    constexpr errc ZPP_BITS_INLINE fetch_message(std::size_t size)
+    {
+        if constexpr (streaming) {
+            if (size > m_data.size() - m_position) [[unlikely]] {
+                return underflow(size);
+            }
+        }
+        return {};
+    }
+
+    // The input at the position, as the byte type of a view aliasing it.
+    template <typename ValueType>
+    constexpr auto view_data()
+    {
+        auto data = m_data.data() + m_position;
+        if constexpr (std::same_as<std::remove_cv_t<
+                                       std::remove_pointer_t<decltype(data)>>,
+                                   ValueType>) {
+            return static_cast<const ValueType *>(data);
+        } else {
+            return reinterpret_cast<const ValueType *>(data);
+        }
+    }
+
+    // Skips an encoded Type, without committing streaming input, see skip().
+    template <typename Type>
+    constexpr errc skip_one()
+    {
+        using type = std::remove_cvref_t<Type>;
+
+        if constexpr (constexpr auto size = traits::fixed_size<type, Options...>();
+                      size != unbounded_size) {
+            return advance(size);
+        } else if constexpr (concepts::optional<type>) {
+            std::byte has_value{};
+            if (auto result = serialize_one(has_value); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+            if (!bool(has_value)) {
+                return {};
+            }
+            return skip_one<typename type::value_type>();
+        } else if constexpr (concepts::tuple<type>) {
+            return skip_elements<type>(
+                std::make_index_sequence<std::tuple_size_v<type>>());
+        } else if constexpr (!std::is_void_v<default_size_type> &&
+                             concepts::container<type> &&
+                             (concepts::associative_container<type> ||
+                              requires(type container) {
+                                  container.resize(1);
+                              } ||
+                              requires(type container) {
+                                  container = {container.data(), 1};
+                                  requires type::extent ==
+                                      std::dynamic_extent;
+                              })) {
+            using value_type = typename type::value_type;
+
+            default_size_type size{};
+            if (auto result = serialize_one(size); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+
+            if constexpr (concepts::bit_vector<type>) {
+                return advance(std::size_t(size) / CHAR_BIT +
+                               bool(std::size_t(size) % CHAR_BIT));
+            } else if constexpr (concepts::serialize_as_bytes<in, value_type> &&
+                                 !concepts::associative_container<type>) {
+                if constexpr (align_arrays && alignof(value_type) > 1) {
+                    if (auto result = skip_padding<alignof(value_type)>();
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+                }
+                if (std::size_t(size) >
+                    std::numeric_limits<std::size_t>::max() /
+                        sizeof(value_type)) [[unlikely]] {
+                    return std::errc::result_out_of_range;
+                }
+                return advance(std::size_t(size) * sizeof(value_type));
+            } else if constexpr (constexpr auto element_size =
+                                     traits::fixed_size<value_type,
+                                                        Options...>();
+                                 element_size != unbounded_size &&
+                                 !concepts::associative_container<type>) {
+                if (std::size_t(size) >
+                    std::numeric_limits<std::size_t>::max() / element_size)
+                    [[unlikely]] {
+                    return std::errc::result_out_of_range;
+                }
+                return advance(std::size_t(size) * element_size);
+            } else if constexpr (traits::group_varint<value_type> &&
+                                 requires(type container) {
+                                     std::span{container};
+                                 }) {
+                // Group varints share a control byte between four values,
+                // which holds their lengths.
+                using unsigned_type = std::make_unsigned_t<
+                    traits::underlying_type_t<typename value_type::value_type>>;
+                for (std::size_t index{}; index < size; index += 4) {
+                    std::byte control{};
+                    if (auto result = serialize_one(control); failure(result))
+                        [[unlikely]] {
+                        return result;
+                    }
+                    auto count = std::min<std::size_t>(size - index, 4);
+                    std::size_t length{};
+                    for (std::size_t i = 0; i < count; ++i) {
+                        auto value_length = varint_group_length<unsigned_type>(
+                            (unsigned(control) >> (2 * i)) & 0x3);
+                        if (value_length > sizeof(unsigned_type)) [[unlikely]] {
+                            return std::errc::value_too_large;
+                        }
+                        length += value_length;
+                    }
+                    if (auto result = advance(length); failure(result))
+                        [[unlikely]] {
+                        return result;
+                    }
+                }
+                return {};
+            } else {
+                for (std::size_t index{}; index < size; ++index) {
+                    if (auto result = skip_one<value_type>(); failure(result))
+                        [[unlikely]] {
+                        return result;
+                    }
+                }
+                return {};
+            }
+        } else if constexpr (std::is_class_v<type> &&
+                             concepts::unspecialized<type> &&
+                             !concepts::has_serialize<type> &&
+                             std::same_as<std::remove_cvref_t<
+                                              decltype(protocol)>,
+                                          std::monostate>) {
+            using members = typename decltype(visit_members_types<type>(
+                []<typename... Types>() {
+                    return std::type_identity<std::tuple<Types...>>{};
+                }))::type;
+            return skip_elements<members>(
+                std::make_index_sequence<std::tuple_size_v<members>>());
+        } else {
+            type value{};
+            return serialize_one(value);
+        }
+    }
+
+    template <auto Mask, std::size_t... Indices>
+    constexpr errc project_members(std::index_sequence<Indices...>,
+                                   auto &... members)
+    {
+        errc result{};
+        static_cast<void>(
+            (... &&
+             !failure(result = project_member<Mask[Indices]>(members))));
+        return result;
+    }
+
+    template <bool Selected>
+    constexpr errc project_member(auto & member)
+    {
+        if constexpr (Selected) {
+            return serialize_one(member);
+        } else {
+            return skip_one<std::remove_cvref_t<decltype(member)>>();
+        }
+    }
+
+    template <typename Tuple, std::size_t... Indices>
+    constexpr errc skip_elements(std::index_sequence<Indices...>)
+    {
+        errc result{};
+        static_cast<void>(
+            (... &&
+             !failure(result = skip_one<std::tuple_element_t<Indices, Tuple>>())));
+        return result;
+    }
+
+    // Moves the position size bytes forward, refilling streaming input
+    // as it goes.
+    constexpr errc advance(std::size_t size)
+    {
+        if constexpr (streaming) {
+            while (size > m_data.size() - m_position) {
+                auto available = m_data.size() - m_position;
+                m_position = m_data.size();
+                size -= available;
+                if (auto result = refill(1); failure(result)) [[unlikely]] {
+                    return result;
+                }
+                if (!m_data.size()) [[unlikely]] {
+                    m_shortfall = size;
+                    return std::errc::result_out_of_range;
+                }
+            }
+        } else if (size > m_data.size() - m_position) [[unlikely]] {
+            return underflow(size);
+        }
+        m_position += size;
+        return {};
+    }
+
+    // See basic_out::pad().
+    template <std::size_t Alignment>
+    constexpr errc skip_padding()
+    {
+        auto position = m_position;
+        if constexpr (streaming) {
+            position += m_data.offset();
+        }
+        auto padding = (Alignment - position % Alignment) % Alignment;
+        if (padding > m_data.size() - m_position) [[unlikely]] {
+            if (auto result = underflow(padding); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+        }
+        m_position += padding;
+        return {};
+    }
+
+    // Points a const view of byte serializable elements into the input,
+    // or if the input is misaligned and copy_misaligned is set, into a
+    // copy in the remaining misaligned storage.
+    constexpr errc alias_elements(auto & container, std::size_t size)
+    {
+        using value_type =
+            typename std::remove_cvref_t<decltype(container)>::value_type;
+        static_assert(!streaming,
+                      "Views into streaming input are not supported.");
+
+        if (size > (m_data.size() - m_position) / sizeof(value_type))
+            [[unlikely]] {
+            if (size > std::numeric_limits<std::size_t>::max() /
+                           sizeof(value_type)) [[unlikely]] {
+                return std::errc::result_out_of_range;
+            }
+            return underflow(size * sizeof(value_type));
+        }
+
+        auto data = m_data.data() + m_position;
+        auto size_in_bytes = size * sizeof(value_type);
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(value_type))
+            [[unlikely]] {
+            if constexpr (!copy_misaligned) {
+                return std::errc::bad_address;
+            } else {
+                auto storage = m_misaligned_storage.data();
+                auto padding =
+                    (alignof(value_type) -
+                     reinterpret_cast<std::uintptr_t>(storage) %
+                         alignof(value_type)) %
+                    alignof(value_type);
+                if (padding > m_misaligned_storage.size() ||
+                    size_in_bytes > m_misaligned_storage.size() - padding)
+                    [[unlikely]] {
+                    return std::errc::no_buffer_space;
+                }
+                std::memcpy(storage + padding, data, size_in_bytes);
+                container = {
+                    reinterpret_cast<const value_type *>(storage + padding),
+                    size};
+                m_misaligned_storage =
+                    m_misaligned_storage.subspan(padding + size_in_bytes);
+            }
+        } else {
+            container = {reinterpret_cast<const value_type *>(data), size};
+        }
+        m_position += size_in_bytes;
+        return {};
+    }
+
+    // Replaces the elements of a resizable container of byte serializable
+    // elements with the size elements that follow in the input, which
+    // must be available. Unlike resizing then copying, every byte is
+    // written once, unless the input is misaligned for the elements.
+    errc assign_elements(auto & container, std::size_t size)
+    {
+        using value_type =
+            typename std::remove_cvref_t<decltype(container)>::value_type;
+
+        auto data = m_data.data() + m_position;
+        auto size_in_bytes = size * sizeof(value_type);
+#if __cpp_lib_string_resize_and_overwrite >= 202110L
+        if constexpr (requires {
+                          container.resize_and_overwrite(
+                              size, [](value_type *, std::size_t) {
+                                  return std::size_t{};
+                              });
+                      }) {
+            container.resize_and_overwrite(
+                size, [&](value_type * elements, std::size_t) {
+                    std::memcpy(elements, data, size_in_bytes);
+                    return size;
+                });
+        } else
+#endif
+        if constexpr (std::same_as<std::byte, value_type> ||
+                      std::same_as<char, value_type> ||
+                      std::same_as<unsigned char, value_type>) {
+            auto elements = view_data<value_type>();
+            container.assign(elements, elements + size);
+        } else {
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(value_type))
+                [[unlikely]] {
+                container.resize(size);
+                std::memcpy(container.data(), data, size_in_bytes);
+            } else {
+                auto elements = reinterpret_cast<const value_type *>(data);
+                container.assign(elements, elements + size);
+            }
+        }
+        m_position += size_in_bytes;
+        return {};
+    }
+
+    // Called when fewer than size bytes follow the position.
+    constexpr errc ZPP_BITS_INLINE underflow(std::size_t size)
+    {
+        if constexpr (streaming) {
+            if (auto result = refill(size); failure(result)) [[unlikely]] {
+                return result;
+            }
+            if (size <= m_data.size()) {
+                return {};
+            }
+        }
+        m_shortfall = size - (m_data.size() - m_position);
+        return std::errc::result_out_of_range;
+    }
+
     constexpr errc ZPP_BITS_INLINE serialize_one(concepts::unspecialized auto && item)
     {
         using type = std::remove_cvref_t<decltype(item)>;
@@ -2578,9 +5835,11 @@ private:
         } else if constexpr ( (std::is_aggregate_v<type> || concepts::has_pb_serialize<type> ) && !std::same_as<std::monostate, std::remove_cvref_t<decltype(protocol)>>) {
             return serialize_one_with_protocol(protocol, std::forward<decltype(item)>(item));
         } else if constexpr (std::is_fundamental_v<type> || std::is_enum_v<type>) {
-            auto size = m_data.size();
-            if (sizeof(item) > size - m_position) [[unlikely]] {
-                return std::errc::result_out_of_range;
+            if (sizeof(item) > m_data.size() - m_position) [[unlikely]] {
+                if (auto result = underflow(sizeof(item)); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
             }
             if (std::is_constant_evaluated()) {
                 std::array<std::remove_const_t<byte_type>, sizeof(item)>
@@ -2619,10 +5878,25 @@ private:
                 concepts::byte_type<
                     std::remove_cvref_t<decltype(*item.data())>>);
 
-            auto size = m_data.size();
             auto item_size_in_bytes = item.size_in_bytes();
-            if (item_size_in_bytes > size - m_position) [[unlikely]] {
-                return std::errc::result_out_of_range;
+            if (item_size_in_bytes > m_data.size() - m_position) [[unlikely]] {
+                if constexpr (streaming) {
+                    if (item_size_in_bytes >= m_data.capacity()) {
+                        if (auto result = m_data.read(
+                                m_position,
+                                {reinterpret_cast<std::byte *>(item.data()),
+                                 item_size_in_bytes});
+                            failure(result)) [[unlikely]] {
+                            return result;
+                        }
+                        m_position = 0;
+                        return {};
+                    }
+                }
+                if (auto result = underflow(item_size_in_bytes);
+                    failure(result)) [[unlikely]] {
+                    return result;
+                }
             }
             if (std::is_constant_evaluated()) {
                 std::size_t count = item.count();
@@ -2660,15 +5934,115 @@ private:
                 [&](auto &&... items) constexpr {
                     return serialize_many(items...);
                 });
+        } else if constexpr (batch_aggregate<type>()) {
+            constexpr auto size = traits::fixed_size<type, Options...>();
+            if (size > m_data.size() - m_position) [[unlikely]] {
+                if (auto result = underflow(size); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+
+            auto archive = fixed_in<size>();
+            if (auto result = archive.serialize_one(item); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+            m_position += size;
+            return {};
         } else {
             return visit_members(
                 item,
                 [&](auto &&... items) ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {
-                    return serialize_many(items...);
+                    return serialize_members(items...);
                 });
         }
     }
 
+    // See basic_out::serialize_members().
+    constexpr errc ZPP_BITS_INLINE serialize_members(auto &&... items)
+    {
+        if constexpr (!traits::has_member_runs<
+                          in,
+                          std::remove_cvref_t<decltype(items)>...>()) {
+            return serialize_many(items...);
+        } else {
+            if (std::is_constant_evaluated()) {
+                return serialize_many(items...);
+            }
+            auto members = std::forward_as_tuple(items...);
+            return serialize_runs<traits::member_runs<
+                in,
+                std::remove_cvref_t<decltype(items)>...>()>(members);
+        }
+    }
+
+    template <auto Runs, std::size_t Index = 0>
+    constexpr errc ZPP_BITS_INLINE serialize_runs(auto & members)
+    {
+        if constexpr (Index == Runs.size()) {
+            return {};
+        } else {
+            constexpr auto length = Runs[Index];
+            if (auto result = [&]<std::size_t... Indices>(
+                    std::index_sequence<Indices...>)
+                    ZPP_BITS_CONSTEXPR_INLINE_LAMBDA {
+                        if constexpr (length == 1) {
+                            return serialize_one(std::get<Index>(members));
+                        } else {
+                            auto & first = std::get<Index>(members);
+                            auto & last =
+                                std::get<Index + length - 1>(members);
+                            constexpr auto size =
+                                (0 + ... +
+                                 sizeof(std::get<Index + Indices>(members)));
+                            auto begin = reinterpret_cast<std::byte *>(
+                                std::addressof(first));
+                            auto end = reinterpret_cast<std::byte *>(
+                                           std::addressof(last)) +
+                                       sizeof(last);
+                            if (end - begin == std::ptrdiff_t(size)) {
+                                return serialize_one(
+                                    bytes(std::span{begin, size}));
+                            }
+                            return serialize_many(
+                                std::get<Index + Indices>(members)...);
+                        }
+                    }(std::make_index_sequence<length>());
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+            return serialize_runs<Runs, Index + length>(members);
+        }
+    }
+
+    // See basic_out::batch_aggregate().
+    template <typename Type>
+    constexpr static bool batch_aggregate()
+    {
+        if constexpr (concepts::fixed_span<ByteView>) {
+            return false;
+        } else {
+            constexpr auto size = traits::fixed_size<Type, Options...>();
+            return size != unbounded_size && size != 0 &&
+                   number_of_members<Type>() > 1;
+        }
+    }
+
+    template <std::size_t Size>
+    constexpr auto ZPP_BITS_INLINE fixed_in()
+    {
+        using fixed_view = std::span<byte_type, Size>;
+        if constexpr (endian_aware) {
+            return in<fixed_view, endian::swapped>{
+                fixed_view{m_data.data() + m_position, Size},
+                endian::swapped{}};
+        } else {
+            return in<fixed_view>{
+                fixed_view{m_data.data() + m_position, Size}};
+        }
+    }
+
     template <typename SizeType = default_size_type, std::size_t Count = 0>
     constexpr errc ZPP_BITS_INLINE serialize_one(auto (&array)[Count])
     {
@@ -2677,6 +6051,9 @@ private:
         if constexpr (concepts::serialize_as_bytes<decltype(*this),
                                                    value_type>) {
             return serialize_one(bytes(array));
+        } else if constexpr (concepts::swapped_bytes<decltype(*this),
+                                                     value_type>) {
+            return serialize_swapped(array, Count);
         } else {
             for (auto & item : array) {
                 if (auto result = serialize_one(item); failure(result))
@@ -2696,6 +6073,33 @@ private:
         using value_type = typename type::value_type;
         constexpr auto is_const = std::is_const_v<
             std::remove_reference_t<decltype(container[0])>>;
+        constexpr auto contiguous_bytes =
+            concepts::serialize_as_bytes<decltype(*this), value_type> &&
+            std::is_base_of_v<std::random_access_iterator_tag,
+                              typename std::iterator_traits<
+                                  typename type::iterator>::iterator_category> &&
+            requires { container.data(); };
+        constexpr auto is_byte_view =
+            is_const && (std::same_as<std::byte, value_type> ||
+                         std::same_as<char, value_type> ||
+                         std::same_as<unsigned char, value_type>);
+        constexpr auto is_element_view =
+            is_const && !is_byte_view && contiguous_bytes &&
+            requires(type container, const value_type * data) {
+                container = {data, 1};
+            };
+        constexpr auto contiguous_swapped =
+            !is_const &&
+            concepts::swapped_bytes<decltype(*this), value_type> &&
+            requires { container.data(); };
+        constexpr auto grouped_varints = [] {
+            if constexpr (concepts::varint<value_type>) {
+                return value_type::encoding == varint_encoding::group &&
+                       requires(type container) { std::span{container}; };
+            } else {
+                return false;
+            }
+        }();
 
         if constexpr (!std::is_void_v<SizeType> &&
                       (requires(type container) { container.resize(1); } ||
@@ -2716,6 +6120,14 @@ private:
                 return result;
             }
 
+            if constexpr (align_arrays && contiguous_bytes &&
+                          alignof(value_type) > 1) {
+                if (auto result = skip_padding<alignof(value_type)>();
+                    failure(result)) [[unlikely]] {
+                    return result;
+                }
+            }
+
             if constexpr (requires(type container) {
                               container.resize(size);
                           }) {
@@ -2727,16 +6139,93 @@ private:
                         return std::errc::message_size;
                     }
                 }
+                if constexpr (contiguous_bytes &&
+                              requires(type container,
+                                       const value_type * data) {
+                                  container.assign(data, data);
+                              }) {
+                    if (!std::is_constant_evaluated() &&
+                        std::size_t(size) <= (m_data.size() - m_position) /
+                                                 sizeof(value_type)) {
+                        return assign_elements(container, std::size_t(size));
+                    }
+                } else if constexpr (concepts::bit_vector<type>) {
+                    // Check the size against the input before resizing.
+                    auto size_in_bytes = std::size_t(size) / CHAR_BIT +
+                                         bool(std::size_t(size) % CHAR_BIT);
+                    if (size_in_bytes > m_data.size() - m_position)
+                        [[unlikely]] {
+                        if (auto result = underflow(size_in_bytes);
+                            failure(result)) [[unlikely]] {
+                            return result;
+                        }
+                    }
+                } else if constexpr (!contiguous_swapped &&
+                                     !grouped_varints &&
+                                     requires(type container) {
+                                         container.reserve(1);
+                                         {
+                                             container.emplace_back()
+                                             } -> std::same_as<value_type &>;
+                                         container.erase(container.begin(),
+                                                         container.end());
+                                         container.swap(container);
+                                     }) {
+                    // The reserved size is bounded by the elements that
+                    // the input can hold in case the size is corrupted.
+                    constexpr auto element_size = std::max<std::size_t>(
+                        traits::min_size<value_type, Options...>(), 1);
+                    auto reserved =
+                        std::min(std::size_t(size),
+                                 (m_data.size() - m_position) / element_size);
+                    if constexpr (reuse) {
+                        // Decode into the existing elements, keeping their
+                        // allocations, and construct the rest in place once.
+                        auto existing =
+                            std::min(std::size_t(size), container.size());
+                        container.erase(container.begin() + existing,
+                                        container.end());
+                        container.reserve(reserved);
+                        for (std::size_t index{}; index < existing; ++index) {
+                            if (auto result = serialize_one(container[index]);
+                                failure(result)) [[unlikely]] {
+                                return result;
+                            }
+                        }
+                        for (auto index = existing; index < size; ++index) {
+                            if (auto result =
+                                    serialize_one(container.emplace_back());
+                                failure(result)) [[unlikely]] {
+                                return result;
+                            }
+                        }
+                    } else {
+                        // Decode into a new container, constructing every
+                        // element once, so that on failure the container is
+                        // left unchanged.
+                        type elements;
+                        elements.reserve(reserved);
+                        for (std::size_t index{}; index < size; ++index) {
+                            if (auto result =
+                                    serialize_one(elements.emplace_back());
+                                failure(result)) [[unlikely]] {
+                                return result;
+                            }
+                        }
+                        container.swap(elements);
+                    }
+                    return {};
+                }
                 container.resize(size);
-            } else if constexpr (is_const &&
-                                 (std::same_as<std::byte, value_type> ||
-                                  std::same_as<char, value_type> ||
-                                  std::same_as<unsigned char,
-                                               value_type>)) {
+            } else if constexpr (is_element_view) {
+                return alias_elements(container, size);
+            } else if constexpr (is_byte_view) {
+                static_assert(!streaming,
+                              "Views into streaming input are not supported.");
                 if (size > m_data.size() - m_position) [[unlikely]] {
-                    return std::errc::result_out_of_range;
+                    return underflow(size);
                 }
-                container = {m_data.data() + m_position, size};
+                container = {view_data<value_type>(), size};
                 m_position += size;
             } else {
                 if (size > container.size()) [[unlikely]] {
@@ -2758,9 +6247,12 @@ private:
                            std::same_as<char, value_type> ||
                            std::same_as<
                                unsigned char,
-                               value_type>)&&requires(type container) {
-                              container = {m_data.data(), 1};
+                               value_type>)&&requires(type container,
+                                                      const value_type * data) {
+                              container = {data, 1};
                           }) {
+                static_assert(!streaming,
+                              "Views into streaming input are not supported.");
                 if constexpr (requires {
                                   requires(type::extent !=
                                            std::dynamic_extent);
@@ -2770,20 +6262,49 @@ private:
                               }) {
                     if (type::extent > m_data.size() - m_position)
                         [[unlikely]] {
-                        return std::errc::result_out_of_range;
+                        return underflow(type::extent);
                     }
-                    container = {m_data.data() + m_position, type::extent};
+                    container = {view_data<value_type>(), type::extent};
                     m_position += type::extent;
                 } else if constexpr (std::is_void_v<SizeType>) {
                     auto size = m_data.size();
-                    container = {m_data.data() + m_position,
-                                 size - m_position};
+                    container = {view_data<value_type>(), size - m_position};
                     m_position = size;
                 }
                 return {};
+            } else if constexpr (is_element_view) {
+                if constexpr (requires {
+                                  requires(type::extent !=
+                                           std::dynamic_extent);
+                                  requires std::integral_constant<
+                                      std::size_t,
+                                      type{}.size()>::value;
+                              }) {
+                    return alias_elements(container, type::extent);
+                } else if constexpr (std::is_void_v<SizeType>) {
+                    return alias_elements(
+                        container,
+                        (m_data.size() - m_position) / sizeof(value_type));
+                }
+                return {};
             } else {
                 return serialize_one(bytes(container));
             }
+        } else if constexpr (concepts::bit_vector<type>) {
+            auto size_in_bytes = container.size() / CHAR_BIT +
+                                 bool(container.size() % CHAR_BIT);
+            if (size_in_bytes > m_data.size() - m_position) [[unlikely]] {
+                if (auto result = underflow(size_in_bytes); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+            serialize_bits(container, container.size());
+            return {};
+        } else if constexpr (contiguous_swapped) {
+            return serialize_swapped(container.data(), container.size());
+        } else if constexpr (grouped_varints) {
+            return serialize_one(varint_span(container));
         } else {
             for (auto & item : container) {
                 if (auto result = serialize_one(item); failure(result))
@@ -2812,30 +6333,108 @@ private:
             size = container.size();
         }
 
+        constexpr auto reuse_nodes =
+            reuse && requires { typename type::node_type; };
+
+        std::size_t index{};
+        [[maybe_unused]] std::
+            conditional_t<reuse_nodes, type, std::monostate> nodes;
+        if constexpr (reuse_nodes) {
+            nodes = std::move(container);
+        }
         container.clear();
 
+        if constexpr (requires { container.reserve(std::size_t{}); }) {
+            // The size is bounded by the input so that a corrupted size does
+            // not reserve more than the elements could take.
+            container.reserve(std::min(std::size_t(size),
+                                       m_data.size() - m_position));
+        }
+
+        // Encoded ordered containers are sorted, which makes inserting at the
+        // end amortized constant, and otherwise it is logarithmic as usual.
+        if constexpr (reuse_nodes) {
+            // Decode into the nodes of the previous contents while they
+            // last, and only then allocate new ones.
+            for (; index < size && !nodes.empty(); ++index) {
+                auto node = nodes.extract(nodes.begin());
+                if constexpr (requires { typename type::mapped_type; }) {
+                    if (auto result =
+                            serialize_many(node.key(), node.mapped());
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+                } else {
+                    if (auto result = serialize_one(node.value());
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+                }
+                container.insert(container.end(), std::move(node));
+            }
+        }
+
         constexpr auto destructor = [](auto pointer) constexpr
         {
             access::destruct(*pointer);
         };
 
-        for (std::size_t index{}; index < size; ++index)
+        for (; index < size; ++index)
         {
             if constexpr (requires { typename type::mapped_type; }) {
-                using value_type = std::pair<typename type::key_type,
-                                             typename type::mapped_type>;
-                std::aligned_storage_t<sizeof(value_type),
-                                       alignof(value_type)>
-                    storage;
-
-                std::unique_ptr<value_type, decltype(destructor)> object(
-                    access::placement_new<value_type>(std::addressof(storage)));
-                if (auto result = serialize_one(*object);
-                    failure(result)) [[unlikely]] {
+                using key_type = typename type::key_type;
+                using mapped_type = typename type::mapped_type;
+                std::aligned_storage_t<sizeof(key_type), alignof(key_type)>
+                    key_storage;
+
+                std::unique_ptr<key_type, decltype(destructor)> key(
+                    access::placement_new<key_type>(
+                        std::addressof(key_storage)));
+                if (auto result = serialize_one(*key); failure(result))
+                    [[unlikely]] {
                     return result;
                 }
 
-                container.insert(std::move(*object));
+                if constexpr (std::is_default_constructible_v<mapped_type>) {
+                    // Decode the mapped value in place.
+                    auto previous_size = container.size();
+                    auto position =
+                        container.emplace_hint(container.end(),
+                                               std::piecewise_construct,
+                                               std::forward_as_tuple(
+                                                   std::move(*key)),
+                                               std::tuple<>{});
+                    if (container.size() == previous_size) [[unlikely]] {
+                        mapped_type duplicate{};
+                        if (auto result = serialize_one(duplicate);
+                            failure(result)) [[unlikely]] {
+                            return result;
+                        }
+                        continue;
+                    }
+
+                    if (auto result = serialize_one(position->second);
+                        failure(result)) [[unlikely]] {
+                        container.erase(position);
+                        return result;
+                    }
+                } else {
+                    std::aligned_storage_t<sizeof(mapped_type),
+                                           alignof(mapped_type)>
+                        mapped_storage;
+
+                    std::unique_ptr<mapped_type, decltype(destructor)> mapped(
+                        access::placement_new<mapped_type>(
+                            std::addressof(mapped_storage)));
+                    if (auto result = serialize_one(*mapped);
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
+
+                    container.emplace_hint(container.end(),
+                                           std::move(*key),
+                                           std::move(*mapped));
+                }
             } else {
                 using value_type = typename type::value_type;
 
@@ -2850,7 +6449,7 @@ private:
                     return result;
                 }
 
-                container.insert(std::move(*object));
+                container.insert(container.end(), std::move(*object));
             }
         }
 
@@ -2888,10 +6487,14 @@ private:
             return {};
         }
 
-        if constexpr (std::is_default_constructible_v<value_type>) {
-            if (!optional) {
-                optional = value_type{};
+        if constexpr (reuse || std::is_default_constructible_v<value_type>) {
+            if (optional) {
+                return serialize_one(*optional);
             }
+        }
+
+        if constexpr (std::is_default_constructible_v<value_type>) {
+            optional = value_type{};
 
             if (auto result = serialize_one(*optional); failure(result))
                 [[unlikely]] {
@@ -3034,7 +6637,18 @@ private:
     {
         using type = std::remove_reference_t<decltype(*pointer)>;
 
-        auto loaded = access::make_unique<type>();;
+        if constexpr (reuse && !std::is_polymorphic_v<type>) {
+            if (pointer) {
+                if constexpr (traits::is_unique_ptr<std::remove_cvref_t<
+                                  decltype(pointer)>>::value) {
+                    return serialize_one(*pointer);
+                } else if (pointer.use_count() == 1) {
+                    return serialize_one(*pointer);
+                }
+            }
+        }
+
+        auto loaded = access::make_unique<type>();
         if (auto result = serialize_one(*loaded); failure(result))
             [[unlikely]] {
             return result;
@@ -3052,20 +6666,123 @@ private:
 
         if (size_in_bytes > m_data.size() - m_position)
             [[unlikely]] {
-            return std::errc::result_out_of_range;
+            if (auto result = underflow(size_in_bytes); failure(result))
+                [[unlikely]] {
+                return result;
+            }
         }
 
-        auto data = m_data.data() + m_position;
-        for (std::size_t i = 0; i < size; ++i) {
-            bitset[i] = (static_cast<unsigned char>(data[i / CHAR_BIT]) >>
-                         (i & 0x7)) &
-                        0x1;
+        if constexpr (traits::bitset_bytes_in_order<
+                          std::remove_cvref_t<decltype(bitset)>>()) {
+            if (!std::is_constant_evaluated()) {
+                // Bits past the size must stay clear.
+                bitset.reset();
+                auto data = m_data.data() + m_position;
+                auto bytes = reinterpret_cast<unsigned char *>(
+                    std::addressof(bitset));
+                std::memcpy(bytes, data, size / CHAR_BIT);
+                if constexpr (size % CHAR_BIT != 0) {
+                    bytes[size / CHAR_BIT] =
+                        static_cast<unsigned char>(data[size / CHAR_BIT]) &
+                        ((1u << (size % CHAR_BIT)) - 1);
+                }
+                m_position += size_in_bytes;
+                return {};
+            }
         }
 
-        m_position += size_in_bytes;
+        serialize_bits(bitset, size);
         return {};
     }
 
+    // Reads count contiguous fundamentals with their bytes reversed, in
+    // bulk rather than one at a time.
+    constexpr errc serialize_swapped(auto * elements, std::size_t count)
+    {
+        constexpr auto size = sizeof(*elements);
+
+        if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (auto result = serialize_one(elements[i]); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+            return {};
+        }
+
+        if constexpr (streaming) {
+            // Elements are read as far as they are buffered, then refilled.
+            while (count) {
+                auto fit = std::min(count, (m_data.size() - m_position) / size);
+                if (!fit) {
+                    if (auto result = underflow(size); failure(result))
+                        [[unlikely]] {
+                        return result;
+                    }
+                    continue;
+                }
+                kernels::reverse_element_bytes<size>(
+                    elements, m_data.data() + m_position, fit);
+                elements += fit;
+                count -= fit;
+                m_position += fit * size;
+            }
+            return {};
+        } else {
+            if (count > (m_data.size() - m_position) / size) [[unlikely]] {
+                if (count > std::numeric_limits<std::size_t>::max() / size)
+                    [[unlikely]] {
+                    return std::errc::result_out_of_range;
+                }
+                return underflow(count * size);
+            }
+
+            kernels::reverse_element_bytes<size>(
+                elements, m_data.data() + m_position, count);
+            m_position += count * size;
+            return {};
+        }
+    }
+
+    // Unpacks size bits, lowest first, from the bytes that follow, which
+    // must be available.
+    constexpr void serialize_bits(auto && bits, std::size_t size)
+    {
+        // Containers are walked with iterators, which are cheaper than
+        // indexing into std::vector<bool>.
+        auto position = [&] {
+            if constexpr (requires { bits.begin(); }) {
+                return bits.begin();
+            } else {
+                return std::size_t{};
+            }
+        }();
+        auto next = [&](bool value) {
+            if constexpr (requires { bits.begin(); }) {
+                *position++ = value;
+            } else {
+                bits[position++] = value;
+            }
+        };
+
+        auto data = m_data.data() + m_position;
+        std::size_t index = 0;
+        for (; index + CHAR_BIT <= size; index += CHAR_BIT) {
+            auto value = static_cast<unsigned char>(*data++);
+            for (std::size_t bit = 0; bit < CHAR_BIT; ++bit) {
+                next((value >> bit) & 0x1);
+            }
+        }
+        if (index < size) {
+            auto value = static_cast<unsigned char>(*data);
+            for (std::size_t bit = 0; index + bit < size; ++bit) {
+                next((value >> bit) & 0x1);
+            }
+        }
+        m_position += size / CHAR_BIT + bool(size % CHAR_BIT);
+    }
+
     template <typename SizeType>
     constexpr errc ZPP_BITS_INLINE serialize_one(concepts::unspecialized auto && item) requires 
         (!std::same_as<std::monostate, std::remove_cvref_t<decltype(protocol)>> )
@@ -3083,6 +6800,10 @@ private:
                 [[unlikely]] {
                 return result;
             }
+            if (auto result = fetch_message(size); failure(result))
+                [[unlikely]] {
+                return result;
+            }
 
             if constexpr (requires {typename type::serialize;}) {
                 constexpr auto protocol = type::serialize::value;
@@ -3092,6 +6813,8 @@ private:
                 return protocol(*this, item, size);
             }
         } else {
+            static_assert(!streaming,
+                          "Streaming input requires sized messages.");
             if constexpr (requires {typename type::serialize;}) {
                 constexpr auto protocol = type::serialize::value;
                 return protocol(*this, item);
@@ -3113,14 +6836,25 @@ private:
                 [[unlikely]] {
                 return result;
             }
+            if (auto result = fetch_message(size); failure(result))
+                [[unlikely]] {
+                return result;
+            }
             return protocol(*this, item, size);
         } else {
+            static_assert(!streaming,
+                          "Streaming input requires sized messages.");
             return protocol(*this, item);
         }
     }
 
     view_type m_data{};
     std::size_t m_position{};
+    std::size_t m_shortfall{};
+    [[no_unique_address]] std::conditional_t<copy_misaligned,
+                                             std::span<std::byte>,
+                                             std::monostate>
+        m_misaligned_storage{};
 };
 
 template <typename Type, std::size_t Size, typename... Options>
@@ -3130,13 +6864,206 @@ template <typename Type, typename SizeType, typename... Options>
 in(sized_item<Type, SizeType> &, Options && ...)
     -> in<Type, Options...>;
 
-template <typename Type, typename SizeType, typename... Options>
-in(const sized_item<Type, SizeType> &, Options && ...)
-    -> in<const Type, Options...>;
+template <typename Type, typename SizeType, typename... Options>
+in(const sized_item<Type, SizeType> &, Options && ...)
+    -> in<const Type, Options...>;
+
+template <typename Type, typename SizeType, typename... Options>
+in(sized_item<Type, SizeType> &&, Options && ...)
+    -> in<Type, Options...>;
+
+// Decodes a Type from input that arrives in parts, such as reads from a
+// socket. Members of aggregates and elements of sized containers that
+// were already decoded are kept across calls to resume(), and the one that
+// ran short is decoded again once the missing bytes were appended. The
+// input is buffered, so types that refer into it, such as std::string_view,
+// are not supported.
+template <typename Type, typename... Options>
+class resumable_in
+{
+public:
+    using archive_type = in<std::span<const std::byte>, Options...>;
+
+    resumable_in() = default;
+
+    template <concepts::byte_type ByteType>
+    void append(std::span<ByteType> bytes)
+    {
+        auto data = reinterpret_cast<const std::byte *>(bytes.data());
+        if (m_position == m_data.size()) {
+            m_data.clear();
+            m_position = 0;
+        } else if (m_position > m_data.size() / 2) {
+            m_data.erase(m_data.begin(), m_data.begin() + m_position);
+            m_position = 0;
+        }
+        m_data.insert(m_data.end(), data, data + bytes.size());
+    }
+
+    // Continues decoding, returns std::errc::result_out_of_range while
+    // needed() more bytes are required.
+    errc resume()
+    {
+        if (m_done) {
+            return {};
+        }
+        auto result = resume(m_value, 0);
+        if (failure(result)) [[unlikely]] {
+            if (result == std::errc::result_out_of_range) {
+                m_needed = std::max(m_needed, std::size_t{1});
+            }
+            return result;
+        }
+        m_needed = 0;
+        m_done = true;
+        return {};
+    }
+
+    // At least how many more bytes the last resume() needed.
+    std::size_t needed() const
+    {
+        return m_needed;
+    }
+
+    bool done() const
+    {
+        return m_done;
+    }
+
+    Type & value()
+    {
+        return m_value;
+    }
+
+    // The appended bytes that follow the decoded part of the value.
+    std::span<const std::byte> remaining_data() const
+    {
+        return std::span{m_data}.subspan(m_position);
+    }
+
+    // Starts decoding a new value from the remaining data.
+    void reset()
+    {
+        m_value = Type{};
+        m_cursor.clear();
+        m_needed = 0;
+        m_done = false;
+    }
+
+private:
+    template <typename Item>
+    constexpr static bool has_resumable_members()
+    {
+        if constexpr (!std::is_class_v<Item> ||
+                      !concepts::unspecialized<Item> ||
+                      concepts::has_serialize<Item> ||
+                      concepts::serialize_as_bytes<archive_type, Item> ||
+                      !std::same_as<std::remove_cvref_t<
+                                        decltype(archive_type::protocol)>,
+                                    std::monostate>) {
+            return false;
+        } else {
+            return traits::fixed_size<Item, Options...>() == unbounded_size;
+        }
+    }
+
+    template <typename Item>
+    constexpr static bool has_resumable_elements()
+    {
+        if constexpr (!concepts::container<Item> ||
+                      std::is_void_v<
+                          typename archive_type::default_size_type>) {
+            return false;
+        } else {
+            // Group varints are decoded four at a time, so they are not
+            // resumed element by element.
+            return !concepts::serialize_as_bytes<archive_type,
+                                                 typename Item::value_type> &&
+                   !traits::group_varint<typename Item::value_type> &&
+                   requires(Item item) {
+                       item.data();
+                       item.resize(1);
+                   };
+        }
+    }
+
+    errc resume(auto & item, std::size_t depth)
+    {
+        using type = std::remove_cvref_t<decltype(item)>;
+        if constexpr (has_resumable_members<type>() ||
+                      has_resumable_elements<type>()) {
+            if (m_cursor.size() == depth) {
+                m_cursor.push_back(0);
+            }
+        }
+
+        if constexpr (has_resumable_members<type>()) {
+            errc result{};
+            std::size_t index = 0;
+            auto resume_member = [&](auto & member) {
+                if (index++ < m_cursor[depth]) {
+                    return true;
+                }
+                result = resume(member, depth + 1);
+                if (failure(result)) [[unlikely]] {
+                    return false;
+                }
+                ++m_cursor[depth];
+                return true;
+            };
+            if (!visit_members(item, [&](auto &... members) {
+                    return (resume_member(members) && ...);
+                })) [[unlikely]] {
+                return result;
+            }
+        } else if constexpr (has_resumable_elements<type>()) {
+            // The cursor is zero before the size, then one past the number
+            // of decoded elements.
+            if (!m_cursor[depth]) {
+                typename archive_type::default_size_type size{};
+                if (auto result = resume(size, depth + 1); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+                if constexpr (archive_type::allocation_limit !=
+                              std::numeric_limits<std::size_t>::max()) {
+                    constexpr auto limit = archive_type::allocation_limit /
+                                           sizeof(typename type::value_type);
+                    if (size > limit) [[unlikely]] {
+                        return std::errc::message_size;
+                    }
+                }
+                item.resize(size);
+                m_cursor[depth] = 1;
+            }
+            for (auto i = m_cursor[depth] - 1; i < item.size(); ++i) {
+                if (auto result = resume(item[i], depth + 1); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+                ++m_cursor[depth];
+            }
+        } else {
+            archive_type archive{remaining_data(), Options{}...};
+            if (auto result = archive(item); failure(result)) [[unlikely]] {
+                m_needed = archive.shortfall();
+                return result;
+            }
+            m_position += archive.position();
+            return {};
+        }
+
+        m_cursor.pop_back();
+        return {};
+    }
 
-template <typename Type, typename SizeType, typename... Options>
-in(sized_item<Type, SizeType> &&, Options && ...)
-    -> in<Type, Options...>;
+    std::vector<std::byte> m_data;
+    std::size_t m_position{};
+    std::vector<std::size_t> m_cursor;
+    std::size_t m_needed{};
+    bool m_done{};
+    Type m_value{};
+};
 
 constexpr auto input(auto && view, auto &&... option)
 {
@@ -3159,6 +7086,24 @@ constexpr auto in_out(auto && view, auto &&... option)
             std::forward<decltype(option)>(option)...)};
 }
 
+namespace traits
+{
+template <typename ByteType>
+struct data_container
+{
+    using type = std::vector<ByteType>;
+};
+
+template <concepts::byte_view Container>
+struct data_container<Container>
+{
+    using type = Container;
+};
+
+template <typename ByteType>
+using data_container_t = typename data_container<ByteType>::type;
+} // namespace traits
+
 template <typename ByteType = std::byte>
 constexpr auto data_in_out(auto &&... option)
 {
@@ -3170,7 +7115,7 @@ constexpr auto data_in_out(auto &&... option)
         {
         }
 
-        std::vector<ByteType> data;
+        traits::data_container_t<ByteType> data;
         in<decltype(data), decltype(option) &...> input;
         out<decltype(data), decltype(option)...> output;
     };
@@ -3187,7 +7132,7 @@ constexpr auto data_in(auto &&... option)
         {
         }
 
-        std::vector<ByteType> data;
+        traits::data_container_t<ByteType> data;
         in<decltype(data), decltype(option)...> input;
     };
     return data_in{std::forward<decltype(option)>(option)...};
@@ -3203,7 +7148,7 @@ constexpr auto data_out(auto &&... option)
         {
         }
 
-        std::vector<ByteType> data;
+        traits::data_container_t<ByteType> data;
         out<decltype(data), decltype(option)...> output;
     };
     return data_out{std::forward<decltype(option)>(option)...};
@@ -3480,177 +7425,711 @@ template <typename Function>
 using function_parameters_t =
     typename function_traits<std::remove_cvref_t<Function>>::parameters_type;
 
-template <typename Function>
-using function_return_type_t =
-    typename function_traits<std::remove_cvref_t<Function>>::return_type;
+template <typename Function>
+using function_return_type_t =
+    typename function_traits<std::remove_cvref_t<Function>>::return_type;
+
+constexpr auto success(auto && value_or_errc) requires
+    std::same_as<decltype(value_or_errc.error()), errc>
+{
+    return value_or_errc.success();
+}
+
+constexpr auto failure(auto && value_or_errc) requires
+    std::same_as<decltype(value_or_errc.error()), errc>
+{
+    return value_or_errc.failure();
+}
+
+template <typename Type>
+struct [[nodiscard]] value_or_errc
+{
+    using error_type = errc;
+    using value_type = std::conditional_t<
+        std::is_void_v<Type>,
+        std::nullptr_t,
+        std::conditional_t<
+            std::is_reference_v<Type>,
+            std::add_pointer_t<std::remove_reference_t<Type>>,
+            Type>>;
+
+    constexpr value_or_errc() = default;
+
+    constexpr explicit value_or_errc(auto && value) :
+        m_return_value(std::forward<decltype(value)>(value))
+    {
+    }
+
+    constexpr explicit value_or_errc(error_type error) :
+        m_error(std::forward<decltype(error)>(error)),
+        m_failure(m_error.code != std::errc{})
+    {
+    }
+
+    constexpr value_or_errc(value_or_errc && other) noexcept
+    {
+        if (other.success()) {
+            if constexpr (!std::is_void_v<Type>) {
+                if constexpr (!std::is_reference_v<Type>) {
+                    ::new (std::addressof(m_return_value))
+                        Type(std::move(other.m_return_value));
+                } else {
+                    m_return_value = other.m_return_value;
+                }
+            }
+        } else {
+            m_failure = other.m_failure;
+            std::memcpy(&m_error, &other.m_error, sizeof(m_error));
+        }
+    }
+
+    constexpr ~value_or_errc()
+    {
+        if constexpr (!std::is_void_v<Type> &&
+                      !std::is_trivially_destructible_v<Type>) {
+            if (success()) {
+                m_return_value.~Type();
+            }
+        }
+    }
+
+    constexpr bool success() const noexcept
+    {
+        return !m_failure;
+    }
+
+    constexpr bool failure() const noexcept
+    {
+        return m_failure;
+    }
+
+    constexpr decltype(auto) value() & noexcept
+    {
+        if constexpr (std::is_same_v<Type, decltype(m_return_value)>) {
+            return (m_return_value);
+        } else {
+            return (*m_return_value);
+        }
+    }
+
+    constexpr decltype(auto) value() && noexcept
+    {
+        if constexpr (std::is_same_v<Type, decltype(m_return_value)>) {
+            return std::forward<Type>(m_return_value);
+        } else {
+            return std::forward<Type>(*m_return_value);
+        }
+    }
+
+    constexpr decltype(auto) value() const & noexcept
+    {
+        if constexpr (std::is_same_v<Type, decltype(m_return_value)>) {
+            return (m_return_value);
+        } else {
+            return (*m_return_value);
+        }
+    }
+
+    constexpr auto error() const noexcept
+    {
+        return m_error;
+    }
+
+    #if __has_include("zpp_throwing.h")
+    constexpr zpp::throwing<Type> operator co_await() &&
+    {
+        if (failure()) [[unlikely]] {
+            return error().code;
+        }
+        return std::move(*this).value();
+    }
+
+    constexpr zpp::throwing<Type> operator co_await() const &
+    {
+        if (failure()) [[unlikely]] {
+            return error().code;
+        }
+        return value();
+    }
+#endif
+
+    constexpr decltype(auto) or_throw() &
+    {
+        if (failure()) [[unlikely]] {
+#ifdef __cpp_exceptions
+            throw std::system_error(std::make_error_code(error().code));
+#else
+            std::abort();
+#endif
+        }
+        return value();
+    }
+
+    constexpr decltype(auto) or_throw() &&
+    {
+        if (failure()) [[unlikely]] {
+#ifdef __cpp_exceptions
+            throw std::system_error(std::make_error_code(error().code));
+#else
+            std::abort();
+#endif
+        }
+        return std::move(*this).value();
+    }
+
+    constexpr decltype(auto) or_throw() const &
+    {
+        if (failure()) [[unlikely]] {
+#ifdef __cpp_exceptions
+            throw std::system_error(std::make_error_code(error().code));
+#else
+            std::abort();
+#endif
+        }
+        return value();
+    }
+
+    union
+    {
+        error_type m_error{};
+        value_type m_return_value;
+    };
+    bool m_failure{};
+};
+
+template <typename... Options>
+constexpr auto size_of(auto &&... items)
+{
+    sizer<Options...> sizer{Options{}...};
+    if (auto result = sizer(items...); failure(result)) [[unlikely]] {
+        return value_or_errc<std::size_t>{result};
+    }
+    return value_or_errc<std::size_t>{sizer.position()};
+}
+
+template <typename Container, typename... Options>
+constexpr auto to_exact_impl(auto &&... items)
+{
+    auto size = size_of<Options...>(items...);
+    if (size.failure()) [[unlikely]] {
+        return value_or_errc<Container>{size.error()};
+    }
+
+    // Serialize into a span so that nothing can grow the container, varints
+    // use the exact size checks of non resizable views.
+    Container data(size.value());
+    out out{std::span{data}, Options{}...};
+    if (auto result = out(items...); failure(result)) [[unlikely]] {
+        return value_or_errc<Container>{result};
+    }
+    return value_or_errc<Container>{std::move(data)};
+}
+
+template <typename ByteType = std::byte, typename... Options>
+constexpr auto to_vector_exact(auto &&... items)
+{
+    return to_exact_impl<std::vector<ByteType>, Options...>(items...);
+}
+
+// Like to_vector_exact(), into a buffer that, unlike a vector, is not zero
+// filled before it is overwritten.
+template <typename ByteType = std::byte, typename... Options>
+constexpr auto to_buffer_exact(auto &&... items)
+{
+    return to_exact_impl<buffer<ByteType>, Options...>(items...);
+}
+
+// A member that is decoded on first access. On input the encoded value is
+// kept as a view into the input data, which must outlive it. On output
+// the original bytes are written back unless the value was modified. The
+// value is encoded as a sized byte array of it serialized with Options.
+template <typename Type, typename... Options>
+class lazy
+{
+public:
+    lazy() : m_value(std::in_place), m_modified(true)
+    {
+    }
+
+    lazy(Type value) : m_value(std::move(value)), m_modified(true)
+    {
+    }
+
+    lazy & operator=(Type value)
+    {
+        m_value = std::move(value);
+        m_modified = true;
+        return *this;
+    }
+
+    // Decodes the value on first access.
+    value_or_errc<const Type &> get() const
+    {
+        if (!m_value) {
+            if (auto result = decode(); failure(result)) [[unlikely]] {
+                return value_or_errc<const Type &>{result};
+            }
+        }
+        return value_or_errc<const Type &>{std::addressof(*m_value)};
+    }
+
+    // Decodes the value on first access, to be encoded again on output.
+    value_or_errc<Type &> modify()
+    {
+        if (!m_value) {
+            if (auto result = decode(); failure(result)) [[unlikely]] {
+                return value_or_errc<Type &>{result};
+            }
+        }
+        m_modified = true;
+        return value_or_errc<Type &>{std::addressof(*m_value)};
+    }
+
+    bool decoded() const
+    {
+        return m_value.has_value();
+    }
+
+    bool modified() const
+    {
+        return m_modified;
+    }
+
+    // The input bytes of the value, empty if it was not read from input.
+    std::span<const std::byte> encoded() const
+    {
+        return m_encoded;
+    }
+
+    constexpr static auto serialize(auto & archive, auto & self)
+    {
+        if constexpr (concepts::member_visitor<decltype(archive)>) {
+            return archive(self.m_encoded);
+        } else if constexpr (std::remove_cvref_t<decltype(archive)>::kind() ==
+                             kind::out) {
+            if (!self.m_modified) {
+                return archive(self.m_encoded);
+            }
+            return self.serialize_value(archive);
+        } else {
+            if (auto result = archive(self.m_encoded); failure(result))
+                [[unlikely]] {
+                return result;
+            }
+            self.m_value.reset();
+            self.m_modified = false;
+            return errc{};
+        }
+    }
+
+private:
+    // Writes the value as a sized byte array, measured first so that it is
+    // serialized with Options in place after its size, without a copy.
+    errc serialize_value(auto & archive) const
+    {
+        using archive_type = std::remove_cvref_t<decltype(archive)>;
+        using size_type = typename archive_type::default_size_type;
+
+        auto size = size_of<Options...>(*m_value);
+        if (size.failure()) [[unlikely]] {
+            return size.error();
+        }
+        if constexpr (!std::is_void_v<size_type>) {
+            if (auto result = archive(size_type(size.value()));
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+        }
 
-constexpr auto success(auto && value_or_errc) requires
-    std::same_as<decltype(value_or_errc.error()), errc>
-{
-    return value_or_errc.success();
-}
+        if constexpr (requires { requires archive_type::measuring; }) {
+            archive.position() += size.value();
+            return errc{};
+        } else {
+            if constexpr (archive_type::resizable) {
+                if (auto result = archive.enlarge_for(size.value());
+                    failure(result)) [[unlikely]] {
+                    return result;
+                }
+            }
+            auto data = archive.remaining_data();
+            if (data.size() < size.value()) [[unlikely]] {
+                return std::errc::result_out_of_range;
+            }
+            out out{data.first(size.value()), Options{}...};
+            if (auto result = out(*m_value); failure(result)) [[unlikely]] {
+                return result;
+            }
+            if (out.position() != size.value()) [[unlikely]] {
+                return std::errc::bad_message;
+            }
+            archive.position() += size.value();
+            return errc{};
+        }
+    }
 
-constexpr auto failure(auto && value_or_errc) requires
-    std::same_as<decltype(value_or_errc.error()), errc>
-{
-    return value_or_errc.failure();
-}
+    errc decode() const
+    {
+        Type value{};
+        in in{m_encoded, Options{}...};
+        if (auto result = in(value); failure(result)) [[unlikely]] {
+            return result;
+        }
+        if (!in.remaining_data().empty()) [[unlikely]] {
+            return std::errc::bad_message;
+        }
+        m_value.emplace(std::move(value));
+        return {};
+    }
 
-template <typename Type>
-struct [[nodiscard]] value_or_errc
-{
-    using error_type = errc;
-    using value_type = std::conditional_t<
-        std::is_void_v<Type>,
-        std::nullptr_t,
-        std::conditional_t<
-            std::is_reference_v<Type>,
-            std::add_pointer_t<std::remove_reference_t<Type>>,
-            Type>>;
+    std::span<const std::byte> m_encoded;
+    mutable std::optional<Type> m_value;
+    bool m_modified{};
+};
 
-    constexpr value_or_errc() = default;
+// A container encoded with a table of the end offsets of its elements,
+// so that indexed_view can decode any element without the others. The
+// encoding is a std::uint32_t count, count std::uint32_t end offsets
+// relative to the first element, then the elements. The table is written
+// before the elements and filled in as they are written, so the output
+// must not be segmented.
+template <typename Container>
+struct indexed : public Container
+{
+    using Container::Container;
+    using Container::operator=;
 
-    constexpr explicit value_or_errc(auto && value) :
-        m_return_value(std::forward<decltype(value)>(value))
+    constexpr indexed(Container && other) noexcept(
+        std::is_nothrow_move_constructible_v<Container>) :
+        Container(std::move(other))
     {
     }
 
-    constexpr explicit value_or_errc(error_type error) :
-        m_error(std::forward<decltype(error)>(error))
+    constexpr indexed(const Container & other) : Container(other)
     {
     }
 
-    constexpr value_or_errc(value_or_errc && other) noexcept
+    constexpr static auto serialize(auto & archive, auto & self)
     {
-        if (other.is_value()) {
-            if constexpr (!std::is_void_v<Type>) {
-                if constexpr (!std::is_reference_v<Type>) {
-                    ::new (std::addressof(m_return_value))
-                        Type(std::move(other.m_return_value));
-                } else {
-                    m_return_value = other.m_return_value;
+        using archive_type = std::remove_cvref_t<decltype(archive)>;
+        auto & container = static_cast<
+            std::conditional_t<std::is_const_v<
+                                   std::remove_reference_t<decltype(self)>>,
+                               const Container,
+                               Container> &>(self);
+
+        if constexpr (concepts::member_visitor<decltype(archive)>) {
+            return archive(container);
+        } else if constexpr (archive_type::kind() == kind::out) {
+            static_assert(!archive_type::segmented,
+                          "Indexed containers need contiguous output.");
+            if (container.size() > std::numeric_limits<std::uint32_t>::max())
+                [[unlikely]] {
+                return errc{std::errc::value_too_large};
+            }
+            if (auto result = archive(std::uint32_t(container.size()));
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+
+            auto table = archive.position();
+            for (std::size_t index{}; index < container.size(); ++index) {
+                if (auto result = archive(std::uint32_t{}); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+
+            auto begin = archive.position();
+            for (auto entry = table; auto & item : container) {
+                if (auto result = archive(item); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+                auto end = archive.position();
+                if (end - begin > std::numeric_limits<std::uint32_t>::max())
+                    [[unlikely]] {
+                    return errc{std::errc::value_too_large};
+                }
+                archive.position() = entry;
+                if (auto result = archive(std::uint32_t(end - begin));
+                    failure(result)) [[unlikely]] {
+                    return result;
                 }
+                entry = archive.position();
+                archive.position() = end;
             }
+            return errc{};
         } else {
-            m_failure = other.m_failure;
-            std::memcpy(&m_error, &other.m_error, sizeof(m_error));
+            std::uint32_t size{};
+            if (auto result = archive(size); failure(result)) [[unlikely]] {
+                return result;
+            }
+            if constexpr (archive_type::allocation_limit !=
+                          std::numeric_limits<std::size_t>::max()) {
+                constexpr auto limit =
+                    archive_type::allocation_limit /
+                    sizeof(typename Container::value_type);
+                if (size > limit) [[unlikely]] {
+                    return errc{std::errc::message_size};
+                }
+            }
+            for (std::size_t index{}; index < size; ++index) {
+                std::uint32_t end{};
+                if (auto result = archive(end); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+            container.resize(size);
+            for (auto & item : container) {
+                if (auto result = archive(item); failure(result))
+                    [[unlikely]] {
+                    return result;
+                }
+            }
+            return errc{};
         }
     }
+};
 
-    constexpr ~value_or_errc()
+// A view of an indexed container in the input data, which decodes single
+// elements on access. The input data must outlive it.
+template <typename Type, typename... Options>
+class indexed_view
+{
+public:
+    using value_type = Type;
+
+    std::size_t size() const
     {
-        if constexpr (!std::is_void_v<Type> &&
-                      !std::is_trivially_destructible_v<Type>) {
-            if (success()) {
-                m_return_value.~Type();
-            }
-        }
+        return m_size;
     }
 
-    constexpr bool success() const noexcept
+    bool empty() const
     {
-        return !m_failure;
+        return !m_size;
     }
 
-    constexpr bool failure() const noexcept
+    // The encoded bytes of an element.
+    value_or_errc<std::span<const std::byte>> encoded(std::size_t index) const
     {
-        return m_failure;
+        using result_type = value_or_errc<std::span<const std::byte>>;
+        if (index >= m_size) [[unlikely]] {
+            return result_type{errc{std::errc::result_out_of_range}};
+        }
+        auto begin = index ? end_offset(index - 1) : 0;
+        auto end = end_offset(index);
+        if (end < begin || end > m_data.size()) [[unlikely]] {
+            return result_type{errc{std::errc::illegal_byte_sequence}};
+        }
+        return result_type{m_data.subspan(begin, end - begin)};
     }
 
-    constexpr decltype(auto) value() & noexcept
+    value_or_errc<Type> at(std::size_t index) const
     {
-        if constexpr (std::is_same_v<Type, decltype(m_return_value)>) {
-            return (m_return_value);
-        } else {
-            return (*m_return_value);
+        auto data = encoded(index);
+        if (data.failure()) [[unlikely]] {
+            return value_or_errc<Type>{data.error()};
         }
+        Type value{};
+        in in{data.value(), Options{}...};
+        if (auto result = in(value); failure(result)) [[unlikely]] {
+            return value_or_errc<Type>{result};
+        }
+        if (in.position() != data.value().size()) [[unlikely]] {
+            return value_or_errc<Type>{errc{std::errc::bad_message}};
+        }
+        return value_or_errc<Type>{std::move(value)};
     }
 
-    constexpr decltype(auto) value() && noexcept
+    constexpr static auto serialize(auto & archive, auto & self)
     {
-        if constexpr (std::is_same_v<Type, decltype(m_return_value)>) {
-            return std::forward<Type>(m_return_value);
+        using archive_type = std::remove_cvref_t<decltype(archive)>;
+        if constexpr (concepts::member_visitor<decltype(archive)>) {
+            return archive(self.m_table);
+        } else if constexpr (archive_type::kind() == kind::out) {
+            if (auto result = archive(std::uint32_t(self.m_size));
+                failure(result)) [[unlikely]] {
+                return result;
+            }
+            return archive(unsized(self.m_table), unsized(self.m_data));
         } else {
-            return std::forward<Type>(*m_return_value);
+            static_assert(!archive_type::streaming,
+                          "Views into streaming input are not supported.");
+            std::uint32_t size{};
+            if (auto result = archive(size); failure(result)) [[unlikely]] {
+                return result;
+            }
+
+            auto data = archive.remaining_data();
+            auto table_size = std::size_t(size) * sizeof(std::uint32_t);
+            if (table_size > data.size()) [[unlikely]] {
+                return errc{std::errc::result_out_of_range};
+            }
+
+            indexed_view view;
+            view.m_size = size;
+            view.m_table = {reinterpret_cast<const std::byte *>(data.data()),
+                            table_size};
+            auto data_size = size ? view.end_offset(size - 1) : 0;
+            if (data_size > data.size() - table_size) [[unlikely]] {
+                return errc{std::errc::result_out_of_range};
+            }
+            view.m_data = {view.m_table.data() + table_size, data_size};
+            archive.position() += table_size + data_size;
+            self = view;
+            return errc{};
         }
     }
 
-    constexpr decltype(auto) value() const & noexcept
+private:
+    // The table was checked to hold size offsets when it was decoded.
+    std::size_t end_offset(std::size_t index) const
     {
-        if constexpr (std::is_same_v<Type, decltype(m_return_value)>) {
-            return (m_return_value);
-        } else {
-            return (*m_return_value);
+        std::uint32_t end;
+        std::memcpy(&end, m_table.data() + index * sizeof(end), sizeof(end));
+        if constexpr (in<std::span<const std::byte>, Options...>::endian_aware) {
+            end = kernels::byteswap(end);
         }
+        return end;
     }
 
-    constexpr auto error() const noexcept
+    std::span<const std::byte> m_table;
+    std::span<const std::byte> m_data;
+    std::size_t m_size{};
+};
+
+#if __has_include(<sys/mman.h>)
+// A read only mapping of a whole file, which input archives read as a
+// std::span<const std::byte>. Decoded string views and byte spans alias the
+// mapping, use decode_mapped() to keep it alive for as long as they live.
+class mapped_file
+{
+public:
+    using value_type = const std::byte;
+
+    mapped_file() = default;
+
+    mapped_file(mapped_file && other) noexcept :
+        m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0))
     {
-        return m_error;
     }
 
-    #if __has_include("zpp_throwing.h")
-    constexpr zpp::throwing<Type> operator co_await() &&
+    mapped_file & operator=(mapped_file && other) noexcept
     {
-        if (failure()) [[unlikely]] {
-            return error().code;
-        }
-        return std::move(*this).value();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
     }
 
-    constexpr zpp::throwing<Type> operator co_await() const &
+    ~mapped_file()
     {
-        if (failure()) [[unlikely]] {
-            return error().code;
+        if (m_data) {
+            ::munmap(const_cast<std::byte *>(m_data), m_size);
         }
-        return value();
     }
-#endif
 
-    constexpr decltype(auto) or_throw() &
+    static value_or_errc<mapped_file> open(const char * path)
     {
-        if (failure()) [[unlikely]] {
-#ifdef __cpp_exceptions
-            throw std::system_error(std::make_error_code(error().code));
-#else
-            std::abort();
-#endif
+        int fd{};
+        do {
+            fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        } while (fd < 0 && errno == EINTR);
+        if (fd < 0) [[unlikely]] {
+            return value_or_errc<mapped_file>{errc{std::errc(errno)}};
         }
-        return value();
+        auto file = map(fd);
+        ::close(fd);
+        return file;
     }
 
-    constexpr decltype(auto) or_throw() &&
+    // Maps the file behind fd, which may be closed afterwards.
+    static value_or_errc<mapped_file> map(int fd)
     {
-        if (failure()) [[unlikely]] {
-#ifdef __cpp_exceptions
-            throw std::system_error(std::make_error_code(error().code));
-#else
-            std::abort();
-#endif
+        struct stat status{};
+        if (::fstat(fd, &status) < 0) [[unlikely]] {
+            return value_or_errc<mapped_file>{errc{std::errc(errno)}};
         }
-        return std::move(*this).value();
+
+        mapped_file file;
+        auto size = std::size_t(status.st_size);
+        if (!size) {
+            return value_or_errc<mapped_file>{std::move(file)};
+        }
+
+        auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) [[unlikely]] {
+            return value_or_errc<mapped_file>{errc{std::errc(errno)}};
+        }
+        file.m_data = static_cast<const std::byte *>(data);
+        file.m_size = size;
+
+        // Archives read front to back, start the read ahead right away.
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        ::madvise(data, size, MADV_WILLNEED);
+        return value_or_errc<mapped_file>{std::move(file)};
     }
 
-    constexpr decltype(auto) or_throw() const &
+    const std::byte * data() const
     {
-        if (failure()) [[unlikely]] {
-#ifdef __cpp_exceptions
-            throw std::system_error(std::make_error_code(error().code));
-#else
-            std::abort();
-#endif
-        }
-        return value();
+        return m_data;
     }
 
-    union
+    std::size_t size() const
     {
-        error_type m_error{};
-        value_type m_return_value;
-    };
-    bool m_failure{};
+        return m_size;
+    }
+
+    const std::byte * begin() const
+    {
+        return m_data;
+    }
+
+    const std::byte * end() const
+    {
+        return m_data + m_size;
+    }
+
+private:
+    const std::byte * m_data{};
+    std::size_t m_size{};
 };
 
+// Decodes a Type from the mapping into a shared pointer which also owns
+// the mapping, so views into it are valid for as long as any copy of the
+// pointer lives.
+template <typename Type, typename... Options>
+auto decode_mapped(mapped_file file, Options &&... options)
+{
+    struct holder
+    {
+        mapped_file file;
+        Type value{};
+    };
+
+    auto owner = std::make_shared<holder>();
+    owner->file = std::move(file);
+    in in{owner->file, std::forward<Options>(options)...};
+    if (auto result = in(owner->value); failure(result)) [[unlikely]] {
+        return value_or_errc<std::shared_ptr<Type>>{result};
+    }
+    return value_or_errc<std::shared_ptr<Type>>{
+        std::shared_ptr<Type>(owner, std::addressof(owner->value))};
+}
+
+template <typename Type, typename... Options>
+auto decode_mapped(const char * path, Options &&... options)
+{
+    auto file = mapped_file::open(path);
+    if (file.failure()) [[unlikely]] {
+        return value_or_errc<std::shared_ptr<Type>>{file.error()};
+    }
+    return decode_mapped<Type>(std::move(file).value(),
+                               std::forward<Options>(options)...);
+}
+#endif
+
 constexpr auto ZPP_BITS_INLINE
 apply(auto && function, auto && archive) requires(
     std::remove_cvref_t<decltype(archive)>::kind() == kind::in)
@@ -4143,11 +8622,8 @@ struct rpc_impl
                     return errc{};
                 } else if constexpr (
                     requires {
-                        std::same_as<
-                            typename decltype(FirstBinding::call(
-                                in, out, context))::value_type,
-                            value_or_errc<decltype(FirstBinding::call(
-                                in, out, context))>>;
+                        typename decltype(FirstBinding::call(
+                            in, out, context))::value_type;
                     }) {
                     if (auto result = FirstBinding::call(in, out, context);
                         failure(result)) [[unlikely]] {
@@ -4251,11 +8727,8 @@ struct rpc_impl
                     co_return;
                 } else if constexpr (
                     requires {
-                        std::same_as<
-                            typename decltype(FirstBinding::call(
-                                in, out, context))::value_type,
-                            value_or_errc<decltype(FirstBinding::call(
-                                in, out, context))>>;
+                        typename decltype(FirstBinding::call(
+                            in, out, context))::value_type;
                     }) {
                     if (auto result = FirstBinding::call(in, out, context);
                         failure(result)) [[unlikely]] {
@@ -4646,8 +9119,12 @@ struct pb
         using type = std::remove_cvref_t<Type>;
         if constexpr (is_pb_field<type>()) {
             return check_type<typename type::pb_field_type>();
+        } else if constexpr (concepts::varint<type>) {
+            static_assert(type::encoding == varint_encoding::normal ||
+                              type::encoding == varint_encoding::zig_zag,
+                          "Protocol buffers varints are base 128 varints.");
+            return true;
         } else if constexpr (!std::is_class_v<type> ||
-                             concepts::varint<type> ||
                              concepts::empty<type>  ||
                              concepts::has_pb_serialize<type>) {
             return true;
@@ -4797,7 +9274,7 @@ struct pb
                     return result;
                 }
 
-                return archive.template serialize_sized<vsize_t>( [this, item = std::forward<T>(item), ... rest = std::forward<Rest>(rest)]() {
+                return archive.template serialize_sized<vsize_t>( [item = std::forward<T>(item), ... rest = std::forward<Rest>(rest)](auto & archive) {
                    return serialize_many<TagType>(std::make_index_sequence<1+sizeof...(rest)>(), archive, item, rest...);
                 });
             }
@@ -4909,8 +9386,12 @@ struct pb
         static_assert(check_type<type>());
         using archive_type = typename std::remove_cvref_t<decltype(archive)>;
         constexpr auto field_protocol = make_pb(field_options<type>());
-        if constexpr (!concepts::varint<
-                          typename archive_type::default_size_type> ||
+        if constexpr (!requires {
+                          requires concepts::varint<
+                              typename archive_type::default_size_type>;
+                          requires archive_type::default_size_type::encoding ==
+                              varint_encoding::normal;
+                      } ||
                       ((std::endian::little != std::endian::native) &&
                        !archive_type::endian_aware)) {
             out out{archive.data(),
@@ -4925,6 +9406,9 @@ struct pb
                     alloc_limit<archive_type::allocation_limit>{},
                     protocol_option<protocol<pb_default{}>>{}};
             out.position() = archive.position();
+            if constexpr (archive_type::resizable) {
+                out.written() = archive.written();
+            }
             auto result = field_protocol.serialize_members(out, item);
             archive.position() = out.position();
             return result;
@@ -5106,11 +9590,15 @@ struct pb
             if (!size) [[unlikely]] {
                 return {};
             }
-            if (auto result = archive(tag, varint{size}, unsized(item));
-                failure(result)) [[unlikely]] {
+            if (auto result = archive(tag, varint{size}); failure(result))
+                [[unlikely]] {
                 return result;
             }
-            return {};
+            if constexpr (requires { std::span{item}; }) {
+                return serialize_varints(archive, varint_span(item), size);
+            } else {
+                return archive(unsized(item));
+            }
         } else if constexpr (requires {
                                  requires std::is_enum_v<
                                      typename type::value_type>;
@@ -5129,14 +9617,18 @@ struct pb
                 [[unlikely]] {
                 return result;
             }
-            for (auto & element : item) {
-                if (auto result = archive(
-                        varint{std::underlying_type_t<type>(element)});
-                    failure(result)) [[unlikely]] {
-                    return result;
+            if constexpr (requires { std::span{item}; }) {
+                return serialize_varints(archive, varint_span(item), size);
+            } else {
+                for (auto & element : item) {
+                    if (auto result = archive(
+                            varint{std::underlying_type_t<type>(element)});
+                        failure(result)) [[unlikely]] {
+                        return result;
+                    }
                 }
+                return {};
             }
-            return {};
         } else {
             constexpr auto tag = make_tag_explicit<typename type::value_type>(field_num);
             for (auto & element : item) {
@@ -5440,11 +9932,39 @@ struct pb
                     item.resize(length / sizeof(value_type));
                     return archive(unsized(item));
                 } else {
+                    auto end_position = length + archive.position();
+                    if constexpr (concepts::varint<value_type> &&
+                                  requires {
+                                      item.resize(1);
+                                      std::span{item};
+                                  }) {
+                        auto data = archive.remaining_data();
+                        if (!std::is_constant_evaluated() &&
+                            length <= data.size()) {
+                            // Varints that end within the field are
+                            // counted, then decoded at once in place.
+                            auto count = kernels::count_varints(
+                                reinterpret_cast<const std::byte *>(
+                                    data.data()),
+                                length);
+                            auto size = item.size();
+                            item.resize(size + count);
+                            if (auto result = archive(
+                                    varint_span<orig_value_type,
+                                                value_type::encoding>(
+                                        std::span{item}.subspan(size)));
+                                failure(result)) [[unlikely]] {
+                                return result;
+                            }
+                        }
+                    }
+
                     if constexpr (requires { item.reserve(1); }) {
-                        item.reserve(length);
+                        if (archive.position() < end_position) {
+                            item.reserve(length);
+                        }
                     }
 
-                    auto end_position = length + archive.position();
                     while (archive.position() < end_position) {
                         if (auto result = fetch(); failure(result))
                             [[unlikely]] {